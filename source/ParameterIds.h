@@ -22,9 +22,20 @@ enum ParameterId : Vst::ParamID {
   kParamOscFilterResonance,
   kParamOscFilterEnv,
   kParamRandomizeAmount,
-  kParamGlobalCount
+  kParamGlobalCount,
+  // Kit morph (A = the current parameters, B = a factory kit). Global slots in the dense store, but
+  // listed after the lane parameters in allParameterIds () so older saved layouts stay a prefix.
+  kParamKitMorph = kParamGlobalCount,
+  kParamKitMorphTarget,
+  // Render quality of the voice nonlinearities: 0 = standard, 1 = anti-aliased. Listed last.
+  kParamQuality
 };
 
+constexpr int32 kKitMorphParamCount = 2;
+constexpr int32 kQualityParamCount = 1;
+// Globals past kParamGlobalCount, which still own the first dense slots.
+constexpr int32 kTrailingGlobalParamCount = kKitMorphParamCount + kQualityParamCount;
+
 enum LaneParamOffset : int32 {
   kLaneTune = 0,
   kLaneDecay,
@@ -75,6 +86,15 @@ constexpr Vst::ParamID kLaneMuteParamBase = 600;
 constexpr int32 kLaneMuteParamCount = kLaneCount;
 constexpr Vst::ParamID kLaneOscMixParamBase = 700;
 constexpr int32 kLaneOscMixParamCount = kLaneCount;
+// Oversampling factor of each lane's fold and drive stages (1x / 2x / 4x). Listed last in
+// allParameterIds (), after the trailing globals.
+constexpr Vst::ParamID kLaneOversamplingParamBase = 800;
+constexpr int32 kLaneOversamplingParamCount = kLaneCount;
+// Sent by the controller to the processor when a lane's factor changes, with int attributes
+// lane and factor, so the processor reports the new latency before the host is asked for it.
+constexpr const char* kOversamplingMessageId = "LaneOversampling";
+constexpr const char* kOversamplingMessageLane = "lane";
+constexpr const char* kOversamplingMessageFactor = "factor";
 
 constexpr Vst::ParamID kLaneCoreMaxParamId = kLaneParamBase + (kLaneCount * kLaneParamCount) - 1;
 constexpr Vst::ParamID kLaneExtraMaxParamId = kLaneExtraParamBase + (kLaneCount * kLaneExtraParamCount) - 1;
@@ -83,12 +103,13 @@ constexpr Vst::ParamID kLaneFilterMaxParamId = kLaneFilterParamBase + (kLaneCoun
 
 constexpr Vst::ParamID kLaneMuteMaxParamId = kLaneMuteParamBase + kLaneMuteParamCount - 1;
 constexpr Vst::ParamID kLaneOscMixMaxParamId = kLaneOscMixParamBase + kLaneOscMixParamCount - 1;
-constexpr Vst::ParamID kMaxParamId = kLaneOscMixMaxParamId;
+constexpr Vst::ParamID kLaneOversamplingMaxParamId = kLaneOversamplingParamBase + kLaneOversamplingParamCount - 1;
+constexpr Vst::ParamID kMaxParamId = kLaneOversamplingMaxParamId;
 constexpr int32 kParameterStateSize = kMaxParamId + 1;
 constexpr int32 kTotalParameterCount =
   kParamGlobalCount + (kLaneCount * kLaneParamCount) + (kLaneCount * kLaneExtraParamCount) +
   (kLaneCount * kLaneMacroParamCount) + (kLaneCount * kLaneFilterParamCount) + kLaneMuteParamCount +
-  kLaneOscMixParamCount;
+  kLaneOscMixParamCount + kTrailingGlobalParamCount + kLaneOversamplingParamCount;
 
 // Saved projects from builds with 9 lanes (v7 and earlier migration paths).
 constexpr int32 kV7LaneCount = 9;
@@ -132,6 +153,16 @@ inline constexpr Vst::ParamID laneOscMixParamID (int32 lane)
   return kLaneOscMixParamBase + lane;
 }
 
+inline constexpr Vst::ParamID laneOversamplingParamID (int32 lane)
+{
+  return kLaneOversamplingParamBase + lane;
+}
+
+inline constexpr bool isLaneOversamplingParamID (Vst::ParamID paramId)
+{
+  return paramId >= kLaneOversamplingParamBase && paramId <= kLaneOversamplingMaxParamId;
+}
+
 inline constexpr bool isLaneLedParamID (Vst::ParamID paramId)
 {
   return paramId >= kLaneLedParamBase && paramId < (kLaneLedParamBase + kLaneLedParamCount);
@@ -193,6 +224,116 @@ inline constexpr int32 laneFilterOffsetFromParamID (Vst::ParamID paramId)
   return (paramId - kLaneFilterParamBase) % kLaneFilterParamCount;
 }
 
+constexpr uint32 kAllLanesMask = (1u << kLaneCount) - 1;
+
+// Lanes whose LaneFrame is derived from paramId: its own lane for per-lane sound parameters,
+// every lane for the global osc filter and the morph slider, none for transport, mix and UI state.
+inline constexpr uint32 laneFrameDependencyMask (Vst::ParamID paramId)
+{
+  if (paramId == kParamOscFilterCutoff || paramId == kParamOscFilterResonance || paramId == kParamOscFilterEnv ||
+      paramId == kParamRandomizeAmount)
+    return kAllLanesMask;
+
+  int32 lane = laneFromParamID (paramId);
+  if (lane < 0)
+    lane = laneFromExtraParamID (paramId);
+  if (lane < 0)
+    lane = laneFromMacroParamID (paramId);
+  if (lane < 0)
+    lane = laneFromFilterParamID (paramId);
+  if (lane < 0 && paramId >= kLaneOscMixParamBase && paramId <= kLaneOscMixMaxParamId)
+    lane = static_cast<int32> (paramId - kLaneOscMixParamBase);
+  return lane < 0 ? 0u : (1u << lane);
+}
+
+// Dense parameter store layout: the globals, then one fixed-stride block per lane holding every
+// parameter of that lane (core, extra, macro, filter, LED, mute, osc mix, oversampling). A lane
+// block spans exactly kLaneDenseStride doubles, i.e. whole 64-byte cache lines.
+constexpr int32 kGlobalDenseSlots = 16;
+constexpr int32 kLaneDenseParamCount = static_cast<int32> (kLaneParamCount) + kLaneExtraParamCount +
+                                       kLaneMacroParamCount + kLaneFilterParamCount + 4;
+constexpr int32 kLaneDenseStride = 32;
+constexpr int32 kDenseParameterCount = kGlobalDenseSlots + (kLaneCount * kLaneDenseStride);
+using ParameterImage = std::array<double, kDenseParameterCount>;
+static_assert (kParamGlobalCount + kTrailingGlobalParamCount <= kGlobalDenseSlots, "globals overflow their dense slots");
+static_assert (kLaneDenseParamCount <= kLaneDenseStride, "lane parameters overflow the lane stride");
+static_assert ((kGlobalDenseSlots * sizeof (double)) % 64 == 0 && (kLaneDenseStride * sizeof (double)) % 64 == 0,
+               "dense blocks must start on cache line boundaries");
+
+constexpr int32 kLaneDenseExtraOffset = static_cast<int32> (kLaneParamCount);
+constexpr int32 kLaneDenseMacroOffset = kLaneDenseExtraOffset + kLaneExtraParamCount;
+constexpr int32 kLaneDenseFilterOffset = kLaneDenseMacroOffset + kLaneMacroParamCount;
+constexpr int32 kLaneDenseLedOffset = kLaneDenseFilterOffset + kLaneFilterParamCount;
+constexpr int32 kLaneDenseMuteOffset = kLaneDenseLedOffset + 1;
+constexpr int32 kLaneDenseOscMixOffset = kLaneDenseMuteOffset + 1;
+constexpr int32 kLaneDenseOversamplingOffset = kLaneDenseOscMixOffset + 1;
+
+inline constexpr int32 laneDenseIndex (int32 lane, int32 slot)
+{
+  return kGlobalDenseSlots + (lane * kLaneDenseStride) + slot;
+}
+
+inline constexpr std::array<int16, kParameterStateSize> makeDenseParamIndexMap ()
+{
+  std::array<int16, kParameterStateSize> map {};
+  for (auto& index : map)
+    index = -1;
+  for (int32 i = 0; i < kParamGlobalCount + kTrailingGlobalParamCount; ++i)
+    map[i] = static_cast<int16> (i);
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    for (int32 param = 0; param < kLaneParamCount; ++param)
+      map[laneParamID (lane, static_cast<LaneParamOffset> (param))] = static_cast<int16> (laneDenseIndex (lane, param));
+    for (int32 param = 0; param < kLaneExtraParamCount; ++param)
+      map[laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (param))] =
+        static_cast<int16> (laneDenseIndex (lane, kLaneDenseExtraOffset + param));
+    for (int32 param = 0; param < kLaneMacroParamCount; ++param)
+      map[laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (param))] =
+        static_cast<int16> (laneDenseIndex (lane, kLaneDenseMacroOffset + param));
+    for (int32 param = 0; param < kLaneFilterParamCount; ++param)
+      map[laneFilterParamID (lane, static_cast<LaneFilterParamOffset> (param))] =
+        static_cast<int16> (laneDenseIndex (lane, kLaneDenseFilterOffset + param));
+    map[laneLedParamID (lane)] = static_cast<int16> (laneDenseIndex (lane, kLaneDenseLedOffset));
+    map[laneMuteParamID (lane)] = static_cast<int16> (laneDenseIndex (lane, kLaneDenseMuteOffset));
+    map[laneOscMixParamID (lane)] = static_cast<int16> (laneDenseIndex (lane, kLaneDenseOscMixOffset));
+    map[laneOversamplingParamID (lane)] = static_cast<int16> (laneDenseIndex (lane, kLaneDenseOversamplingOffset));
+  }
+  return map;
+}
+
+inline constexpr auto kDenseParamIndexMap = makeDenseParamIndexMap ();
+
+// Slot of paramId in the dense store, -1 for IDs in the gaps between the parameter bases.
+inline constexpr int32 denseParamIndex (Vst::ParamID paramId)
+{
+  if (paramId >= static_cast<Vst::ParamID> (kParameterStateSize))
+    return -1;
+  return kDenseParamIndexMap[paramId];
+}
+
+// Inverse of kDenseParamIndexMap; padding slots hold kParameterStateSize, which no parameter uses.
+inline constexpr std::array<Vst::ParamID, kDenseParameterCount> makeDenseParamIdMap ()
+{
+  std::array<Vst::ParamID, kDenseParameterCount> ids {};
+  for (auto& id : ids)
+    id = static_cast<Vst::ParamID> (kParameterStateSize);
+  for (int32 id = 0; id < kParameterStateSize; ++id)
+  {
+    if (kDenseParamIndexMap[id] >= 0)
+      ids[kDenseParamIndexMap[id]] = static_cast<Vst::ParamID> (id);
+  }
+  return ids;
+}
+
+inline constexpr auto kDenseParamIdMap = makeDenseParamIdMap ();
+
+static_assert (denseParamIndex (kParamRandomizeAmount) == kParamRandomizeAmount);
+static_assert (kDenseParamIdMap[denseParamIndex (laneMuteParamID (3))] == laneMuteParamID (3));
+static_assert (denseParamIndex (laneParamID (1, kLaneTune)) == laneDenseIndex (1, 0));
+static_assert (denseParamIndex (laneOversamplingParamID (kLaneCount - 1)) ==
+               kDenseParameterCount - kLaneDenseStride + kLaneDenseOversamplingOffset);
+static_assert (denseParamIndex (kLaneParamBase - 1) == -1);
+
 inline constexpr std::array<Vst::ParamID, kTotalParameterCount> allParameterIds ()
 {
   std::array<Vst::ParamID, kTotalParameterCount> ids {};
@@ -223,6 +364,11 @@ inline constexpr std::array<Vst::ParamID, kTotalParameterCount> allParameterIds
     ids[index++] = laneMuteParamID (lane);
   for (int32 lane = 0; lane < kLaneCount; ++lane)
     ids[index++] = laneOscMixParamID (lane);
+  ids[index++] = kParamKitMorph;
+  ids[index++] = kParamKitMorphTarget;
+  ids[index++] = kParamQuality;
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+    ids[index++] = laneOversamplingParamID (lane);
   return ids;
 }
 
@@ -1,11 +1,14 @@
 #include "WestCoastController.h"
 
 #include "ParameterIds.h"
+#include "engine/Oversampler.h"
 #include "presets/FactoryPresets.h"
+#include "state/StateMigration.h"
 
-#include "base/source/fstreamer.h"
 #include "pluginterfaces/base/ibstream.h"
+#include "pluginterfaces/base/smartpointer.h"
 #include "pluginterfaces/base/ustring.h"
+#include "pluginterfaces/vst/ivstmessage.h"
 #include "public.sdk/source/vst/vstparameters.h"
 #include "vstgui/plugin-bindings/vst3editor.h"
 #include "vstgui/uidescription/iuidescription.h"
@@ -18,51 +21,6 @@ namespace Steinberg::WestCoastDrumSynth {
 
 namespace {
 
-constexpr uint32 kStateVersion = 8;
-constexpr uint32 kV7StateVersion = 7;
-constexpr uint32 kV6StateVersion = 6;
-constexpr uint32 kV5StateVersion = 5;
-constexpr uint32 kV4StateVersion = 4;
-constexpr uint32 kV3StateVersion = 3;
-constexpr int32 kV4LaneCount = 5;
-constexpr uint32 kPreviousStateVersion = 2;
-constexpr uint32 kLegacyStateVersion = 1;
-constexpr int32 kLegacyLaneCount = 4;
-constexpr int32 kPreviousGlobalParamCount = 6;
-
-constexpr std::array<std::array<double, kLaneExtraParamCount>, kLaneCount> kLaneExtraDefaults {{
-  {{0.84, 0.30, 0.76, 0.36, 0.26, 0.24}},
-  {{0.46, 0.48, 0.62, 0.72, 0.58, 0.84}},
-  {{0.20, 0.22, 0.38, 0.90, 0.20, 0.72}},
-  {{0.42, 0.38, 0.48, 0.52, 0.42, 0.48}},
-  {{0.44, 0.36, 0.50, 0.54, 0.44, 0.50}},
-  {{0.52, 0.34, 0.54, 0.60, 0.40, 0.56}},
-  {{0.38, 0.45, 0.62, 0.72, 0.58, 0.65}},
-  {{0.48, 0.40, 0.58, 0.68, 0.52, 0.72}},
-}};
-
-constexpr std::array<std::array<double, kLaneMacroParamCount>, kLaneCount> kLaneMacroDefaults {{
-  {{0.28, 0.44, 0.34, 0.56}},
-  {{0.38, 0.56, 0.50, 0.72}},
-  {{0.20, 0.36, 0.66, 0.86}},
-  {{0.32, 0.48, 0.40, 0.54}},
-  {{0.34, 0.46, 0.42, 0.56}},
-  {{0.36, 0.50, 0.44, 0.58}},
-  {{0.28, 0.54, 0.55, 0.68}},
-  {{0.30, 0.52, 0.50, 0.62}},
-}};
-
-constexpr std::array<std::array<double, kLaneFilterParamCount>, kLaneCount> kLaneFilterDefaults {{
-  {{0.65, 0.08, 0.40, 0.70, 0.05, 0.35}},
-  {{0.68, 0.12, 0.30, 0.72, 0.08, 0.45}},
-  {{0.82, 0.06, 0.20, 0.85, 0.04, 0.30}},
-  {{0.72, 0.12, 0.38, 0.76, 0.08, 0.42}},
-  {{0.74, 0.11, 0.40, 0.78, 0.07, 0.44}},
-  {{0.70, 0.14, 0.36, 0.74, 0.09, 0.40}},
-  {{0.66, 0.18, 0.45, 0.70, 0.12, 0.52}},
-  {{0.68, 0.16, 0.42, 0.72, 0.10, 0.48}},
-}};
-
 UString128 toString128 (const char* ascii)
 {
   return UString128 (ascii ? ascii : "");
@@ -76,20 +34,6 @@ Vst::RangeParameter* makeRangeParam (const char* title, Vst::ParamID id, const c
   return new Vst::RangeParameter (title16, id, unit16, minPlain, maxPlain, defaultPlain);
 }
 
-bool readV7StreamIntoDenseByParamId (IBStreamer& streamer, std::array<double, 709>& out)
-{
-  out.fill (0.0);
-  const auto idsV7 = allParameterIdsV7 ();
-  for (int32 i = 0; i < kV7TotalParameterCount; ++i)
-  {
-    double v = 0.0;
-    if (!streamer.readDouble (v))
-      return false;
-    out[static_cast<size_t> (idsV7[static_cast<size_t> (i)])] = v;
-  }
-  return true;
-}
-
 } // namespace
 
 FUnknown* WestCoastController::createInstance (void*)
@@ -126,6 +70,20 @@ tresult PLUGIN_API WestCoastController::initialize (FUnknown* context)
   parameters.addParameter (presetParam);
   parameters.addParameter (STR16 ("Morph"), nullptr, 1, 0.0, Vst::ParameterInfo::kCanAutomate, kParamRandomize);
   parameters.addParameter (makeRangeParam ("Morph", kParamRandomizeAmount, "%", -50.0, 50.0, 0.0));
+  parameters.addParameter (makeRangeParam ("Kit Morph", kParamKitMorph, "%", 0.0, 100.0, 0.0));
+
+  auto* kitMorphTargetParam = new Vst::StringListParameter (STR16 ("Kit Morph Target"), kParamKitMorphTarget);
+  for (const auto& preset : getFactoryPresets ())
+  {
+    auto presetName = toString128 (preset.name.data ());
+    kitMorphTargetParam->appendString (presetName);
+  }
+  parameters.addParameter (kitMorphTargetParam);
+
+  auto* qualityParam = new Vst::StringListParameter (STR16 ("Quality"), kParamQuality);
+  qualityParam->appendString (STR16 ("Standard"));
+  qualityParam->appendString (STR16 ("Anti-aliased"));
+  parameters.addParameter (qualityParam);
 
   const std::array<std::array<const char*, kLaneParamCount>, kLaneCount> laneTitles {{
     {{"Kick Tune", "Kick Decay", "Kick Fold", "Kick FM", "Kick Noise Level", "Kick Drive", "Kick Output", "Kick Pan"}},
@@ -285,6 +243,21 @@ tresult PLUGIN_API WestCoastController::initialize (FUnknown* context)
   for (int32 lane = 0; lane < kLaneCount; ++lane)
     parameters.addParameter (makeRangeParam (laneOscMixTitles[lane], laneOscMixParamID (lane), "%", 0.0, 100.0, 100.0));
 
+  // Not automatable: every change of factor changes the plug-in latency.
+  const std::array<const char*, kLaneCount> laneOversamplingTitles {
+    "Kick Oversampling", "Snare Oversampling", "Hat Oversampling", "Perc A1 Oversampling", "Perc A2 Oversampling",
+    "Perc B1 Oversampling", "Clap Oversampling", "RimShot Oversampling"};
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    auto title = toString128 (laneOversamplingTitles[lane]);
+    auto* oversamplingParam =
+      new Vst::StringListParameter (title, laneOversamplingParamID (lane), nullptr, Vst::ParameterInfo::kIsList);
+    oversamplingParam->appendString (STR16 ("1x"));
+    oversamplingParam->appendString (STR16 ("2x"));
+    oversamplingParam->appendString (STR16 ("4x"));
+    parameters.addParameter (oversamplingParam);
+  }
+
   return kResultOk;
 }
 
@@ -295,283 +268,35 @@ tresult PLUGIN_API WestCoastController::terminate ()
 
 tresult PLUGIN_API WestCoastController::setComponentState (IBStream* state)
 {
-  if (!state)
+  ParameterStateSnapshot snapshot;
+  if (!readParameterState (state, snapshot))
     return kResultFalse;
 
-  IBStreamer streamer (state, kLittleEndian);
-  uint32 version = 0;
-  if (!streamer.readInt32u (version))
-    return kResultFalse;
-
-  int32 ignoredPreset = 0;
-  if (!streamer.readInt32 (ignoredPreset))
-    return kResultFalse;
-
-  const auto applyMacroDefaults = [this] () {
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-    {
-      for (int32 parameterOffset = 0; parameterOffset < kLaneMacroParamCount; ++parameterOffset)
-      {
-        setParamNormalized (laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (parameterOffset)),
-                            kLaneMacroDefaults[lane][parameterOffset]);
-      }
-    }
-  };
-
-  const auto applyFilterDefaults = [this] () {
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-    {
-      for (int32 parameterOffset = 0; parameterOffset < kLaneFilterParamCount; ++parameterOffset)
-      {
-        setParamNormalized (laneFilterParamID (lane, static_cast<LaneFilterParamOffset> (parameterOffset)),
-                            kLaneFilterDefaults[lane][parameterOffset]);
-      }
-    }
-  };
-
-  if (version == kLegacyStateVersion)
-  {
-    for (int32 param = 0; param < kPreviousGlobalParamCount; ++param)
-    {
-      double value = 0.0;
-      if (!streamer.readDouble (value))
-        return kResultFalse;
-      setParamNormalized (static_cast<Vst::ParamID> (param), value);
-    }
-
-    for (int32 lane = 0; lane < kLegacyLaneCount; ++lane)
-    {
-      for (int32 parameterOffset = 0; parameterOffset < kLaneParamCount; ++parameterOffset)
-      {
-        double value = 0.0;
-        if (!streamer.readDouble (value))
-          return kResultFalse;
-        setParamNormalized (laneParamID (lane, static_cast<LaneParamOffset> (parameterOffset)), value);
-      }
-    }
-
-    for (int32 parameterOffset = 0; parameterOffset < kLaneParamCount; ++parameterOffset)
-    {
-      const auto offset = static_cast<LaneParamOffset> (parameterOffset);
-      double value = getParamNormalized (laneParamID (3, offset));
-      if (offset == kLanePan)
-        value = std::clamp (value + 0.08, 0.0, 1.0);
-      setParamNormalized (laneParamID (4, offset), value);
-    }
-
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-    {
-      for (int32 parameterOffset = 0; parameterOffset < kLaneExtraParamCount; ++parameterOffset)
-        setParamNormalized (laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (parameterOffset)),
-                            kLaneExtraDefaults[lane][parameterOffset]);
-    }
-    applyMacroDefaults ();
-    applyFilterDefaults ();
-    setParamNormalized (kParamOscFilterCutoff, 0.20);
-    setParamNormalized (kParamOscFilterResonance, 0.34);
-    setParamNormalized (kParamOscFilterEnv, 0.46);
-    return kResultOk;
-  }
-
-  if (version == kPreviousStateVersion)
-  {
-    constexpr int32 v2ParamCount =
-      kPreviousGlobalParamCount + (kV4LaneCount * kLaneParamCount) + (kV4LaneCount * kLaneExtraParamCount);
-    constexpr auto v2Ids = [] ()
-    {
-      std::array<Vst::ParamID, v2ParamCount> ids {};
-      int32 index = 0;
-      for (int32 i = 0; i < kPreviousGlobalParamCount; ++i)
-        ids[index++] = static_cast<Vst::ParamID> (i);
-      for (int32 lane = 0; lane < kV4LaneCount; ++lane)
-        for (int32 p = 0; p < kLaneParamCount; ++p)
-          ids[index++] = laneParamID (lane, static_cast<LaneParamOffset> (p));
-      for (int32 lane = 0; lane < kV4LaneCount; ++lane)
-        for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-          ids[index++] = laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p));
-      return ids;
-    }();
-
-    for (const auto id : v2Ids)
-    {
-      double value = 0.0;
-      if (!streamer.readDouble (value))
-        return kResultFalse;
-      setParamNormalized (id, value);
-    }
-    for (int32 lane = kV4LaneCount; lane < kLaneCount; ++lane)
-    {
-      for (int32 p = 0; p < kLaneParamCount; ++p)
-        setParamNormalized (laneParamID (lane, static_cast<LaneParamOffset> (p)), 0.5);
-      for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-        setParamNormalized (laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p)),
-                           kLaneExtraDefaults[lane][p]);
-    }
-    applyMacroDefaults ();
-    applyFilterDefaults ();
-    setParamNormalized (kParamOscFilterCutoff, 0.20);
-    setParamNormalized (kParamOscFilterResonance, 0.34);
-    setParamNormalized (kParamOscFilterEnv, 0.46);
-    return kResultOk;
-  }
-
-  if (version == kV3StateVersion)
-  {
-    constexpr int32 v3ParamCount = kPreviousGlobalParamCount + (kV4LaneCount * kLaneParamCount) +
-                                   (kV4LaneCount * kLaneExtraParamCount) + (kV4LaneCount * kLaneMacroParamCount);
-    constexpr auto v3Ids = [] ()
-    {
-      std::array<Vst::ParamID, v3ParamCount> ids {};
-      int32 index = 0;
-      for (int32 i = 0; i < kPreviousGlobalParamCount; ++i)
-        ids[index++] = static_cast<Vst::ParamID> (i);
-      for (int32 lane = 0; lane < kV4LaneCount; ++lane)
-        for (int32 p = 0; p < kLaneParamCount; ++p)
-          ids[index++] = laneParamID (lane, static_cast<LaneParamOffset> (p));
-      for (int32 lane = 0; lane < kV4LaneCount; ++lane)
-        for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-          ids[index++] = laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p));
-      for (int32 lane = 0; lane < kV4LaneCount; ++lane)
-        for (int32 p = 0; p < kLaneMacroParamCount; ++p)
-          ids[index++] = laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (p));
-      return ids;
-    }();
-
-    for (const auto id : v3Ids)
-    {
-      double value = 0.0;
-      if (!streamer.readDouble (value))
-        return kResultFalse;
-      setParamNormalized (id, value);
-    }
-    for (int32 lane = kV4LaneCount; lane < kLaneCount; ++lane)
-    {
-      for (int32 p = 0; p < kLaneParamCount; ++p)
-        setParamNormalized (laneParamID (lane, static_cast<LaneParamOffset> (p)), 0.5);
-      for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-        setParamNormalized (laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p)),
-                           kLaneExtraDefaults[lane][p]);
-      for (int32 p = 0; p < kLaneMacroParamCount; ++p)
-        setParamNormalized (laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (p)),
-                           kLaneMacroDefaults[lane][p]);
-    }
-    applyFilterDefaults ();
-    setParamNormalized (kParamOscFilterCutoff, 0.20);
-    setParamNormalized (kParamOscFilterResonance, 0.34);
-    setParamNormalized (kParamOscFilterEnv, 0.46);
-    return kResultOk;
-  }
-
-  if (version == kV4StateVersion)
-  {
-    constexpr int32 v4ParamCount = kParamGlobalCount + (kV4LaneCount * kLaneParamCount) +
-                                   (kV4LaneCount * kLaneExtraParamCount) +
-                                   (kV4LaneCount * kLaneMacroParamCount) +
-                                   (kV4LaneCount * kLaneFilterParamCount);
-    for (int32 i = 0; i < v4ParamCount; ++i)
-    {
-      double value = 0.0;
-      if (!streamer.readDouble (value))
-        return kResultFalse;
-      setParamNormalized (allParameterIds ()[i], value);
-    }
-    for (int32 lane = kV4LaneCount; lane < kLaneCount; ++lane)
-    {
-      for (int32 p = 0; p < kLaneParamCount; ++p)
-        setParamNormalized (laneParamID (lane, static_cast<LaneParamOffset> (p)), 0.5);
-      for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-        setParamNormalized (laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p)),
-                           kLaneExtraDefaults[lane][p]);
-      for (int32 p = 0; p < kLaneMacroParamCount; ++p)
-        setParamNormalized (laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (p)),
-                           kLaneMacroDefaults[lane][p]);
-      for (int32 p = 0; p < kLaneFilterParamCount; ++p)
-        setParamNormalized (laneFilterParamID (lane, static_cast<LaneFilterParamOffset> (p)),
-                           kLaneFilterDefaults[lane][p]);
-    }
-    return kResultOk;
-  }
-
-  if (version == kV5StateVersion)
-  {
-    constexpr int32 v5ParamCount = kV7TotalParameterCount - kV7LaneCount - kV7LaneCount - 1;
-    const auto idsV7 = allParameterIdsV7 ();
-    for (int32 i = 0; i < v5ParamCount; ++i)
-    {
-      double value = 0.0;
-      if (!streamer.readDouble (value))
-        return kResultFalse;
-      setParamNormalized (idsV7[static_cast<size_t> (i)], value);
-    }
-    setParamNormalized (kParamRandomizeAmount, 1.0);
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-      setParamNormalized (laneMuteParamID (lane), 0.0);
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-      setParamNormalized (laneOscMixParamID (lane), 1.0);
-    return kResultOk;
-  }
-
-  if (version == kV6StateVersion)
-  {
-    constexpr int32 v6ParamCount = kV7TotalParameterCount - kV7LaneCount;
-    const auto idsV7 = allParameterIdsV7 ();
-    for (int32 i = 0; i < v6ParamCount; ++i)
-    {
-      double value = 0.0;
-      if (!streamer.readDouble (value))
-        return kResultFalse;
-      setParamNormalized (idsV7[static_cast<size_t> (i)], value);
-    }
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-      setParamNormalized (laneOscMixParamID (lane), 1.0);
-    return kResultOk;
-  }
-
-  if (version == kV7StateVersion)
-  {
-    std::array<double, 709> v7Dense {};
-    if (!readV7StreamIntoDenseByParamId (streamer, v7Dense))
-      return kResultFalse;
-
-    auto copyLaneFromV7 = [this, &v7Dense] (int32 destLane, int32 srcLane) {
-      for (int32 p = 0; p < kLaneParamCount; ++p)
-        setParamNormalized (laneParamID (destLane, static_cast<LaneParamOffset> (p)),
-                            v7Dense[laneParamID (srcLane, static_cast<LaneParamOffset> (p))]);
-      for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-        setParamNormalized (laneExtraParamID (destLane, static_cast<LaneExtraParamOffset> (p)),
-                            v7Dense[laneExtraParamID (srcLane, static_cast<LaneExtraParamOffset> (p))]);
-      for (int32 p = 0; p < kLaneMacroParamCount; ++p)
-        setParamNormalized (laneMacroParamID (destLane, static_cast<LaneMacroParamOffset> (p)),
-                            v7Dense[laneMacroParamID (srcLane, static_cast<LaneMacroParamOffset> (p))]);
-      for (int32 p = 0; p < kLaneFilterParamCount; ++p)
-        setParamNormalized (laneFilterParamID (destLane, static_cast<LaneFilterParamOffset> (p)),
-                            v7Dense[laneFilterParamID (srcLane, static_cast<LaneFilterParamOffset> (p))]);
-      setParamNormalized (laneLedParamID (destLane), v7Dense[laneLedParamID (srcLane)]);
-      setParamNormalized (laneMuteParamID (destLane), v7Dense[laneMuteParamID (srcLane)]);
-      setParamNormalized (laneOscMixParamID (destLane), v7Dense[laneOscMixParamID (srcLane)]);
-    };
-
-    for (int32 i = 0; i < kParamGlobalCount; ++i)
-      setParamNormalized (static_cast<Vst::ParamID> (i), v7Dense[static_cast<size_t> (i)]);
-    for (int32 lane = 0; lane < 6; ++lane)
-      copyLaneFromV7 (lane, lane);
-    copyLaneFromV7 (6, 8);
-    copyLaneFromV7 (7, 7);
-    return kResultOk;
-  }
+  forEachAssignedParam (snapshot, [this] (Vst::ParamID id, double value) { setParamNormalized (id, value); });
+  return kResultOk;
+}
 
-  if (version != kStateVersion)
-    return kResultFalse;
+tresult PLUGIN_API WestCoastController::setParamNormalized (Vst::ParamID tag, Vst::ParamValue value)
+{
+  const bool latencyChanged =
+    isLaneOversamplingParamID (tag) &&
+    oversamplingFromNormalized (getParamNormalized (tag)) != oversamplingFromNormalized (value);
+  const tresult result = EditControllerEx1::setParamNormalized (tag, value);
+  if (result != kResultOk || !latencyChanged)
+    return result;
 
-  for (const auto id : allParameterIds ())
+  // The host re-reads getLatencySamples () from the processor on the restart. The factor itself
+  // only reaches the processor with a later block, so tell it first and restart after.
+  if (IPtr<Vst::IMessage> message = owned (allocateMessage ()))
   {
-    double value = 0.0;
-    if (!streamer.readDouble (value))
-      return kResultFalse;
-    setParamNormalized (id, value);
+    message->setMessageID (kOversamplingMessageId);
+    message->getAttributes ()->setInt (kOversamplingMessageLane, tag - kLaneOversamplingParamBase);
+    message->getAttributes ()->setInt (kOversamplingMessageFactor, oversamplingFromNormalized (value));
+    sendMessage (message);
   }
-
-  return kResultOk;
+  if (componentHandler)
+    componentHandler->restartComponent (Vst::kLatencyChanged);
+  return result;
 }
 
 IPlugView* PLUGIN_API WestCoastController::createView (FIDString name)
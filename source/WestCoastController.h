@@ -15,6 +15,7 @@ public:
   tresult PLUGIN_API initialize (FUnknown* context) SMTG_OVERRIDE;
   tresult PLUGIN_API terminate () SMTG_OVERRIDE;
   tresult PLUGIN_API setComponentState (IBStream* state) SMTG_OVERRIDE;
+  tresult PLUGIN_API setParamNormalized (Vst::ParamID tag, Vst::ParamValue value) SMTG_OVERRIDE;
   IPlugView* PLUGIN_API createView (FIDString name) SMTG_OVERRIDE;
 
   VSTGUI::CView* verifyView (VSTGUI::CView* view, const VSTGUI::UIAttributes& attributes,
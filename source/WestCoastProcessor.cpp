@@ -1,110 +1,51 @@
 #include "WestCoastProcessor.h"
 
+#include "engine/ScopedFlushDenormals.h"
+#include "presets/CompiledPresets.h"
 #include "presets/FactoryPresets.h"
+#include "state/StateMigration.h"
 #include "westcoastdrumcids.h"
 
-#include "base/source/fstreamer.h"
 #include "pluginterfaces/vst/ivstevents.h"
+#include "pluginterfaces/vst/ivstmessage.h"
 #include "pluginterfaces/vst/ivstparameterchanges.h"
 #include "pluginterfaces/vst/ivstprocesscontext.h"
 
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstring>
 #include <random>
 #include <type_traits>
-#include <vector>
 
 namespace Steinberg::WestCoastDrumSynth {
 
 namespace {
 
-constexpr uint32 kStateVersion = 8;
-constexpr uint32 kV7StateVersion = 7;
-constexpr uint32 kV6StateVersion = 6;
-constexpr uint32 kV5StateVersion = 5;
-constexpr uint32 kV4StateVersion = 4;
-constexpr uint32 kV3StateVersion = 3;
-constexpr int32 kV4LaneCount = 5;
-constexpr uint32 kPreviousStateVersion = 2;
-constexpr uint32 kLegacyStateVersion = 1;
-constexpr int32 kLegacyLaneCount = 4;
-constexpr int32 kPreviousGlobalParamCount = 6;
-
-constexpr std::array<std::array<double, kLaneExtraParamCount>, kLaneCount> kLaneExtraDefaults {{
-  {{0.84, 0.30, 0.76, 0.36, 0.26, 0.24}},
-  {{0.46, 0.48, 0.62, 0.72, 0.58, 0.84}},
-  {{0.20, 0.22, 0.38, 0.90, 0.20, 0.72}},
-  {{0.42, 0.38, 0.48, 0.52, 0.42, 0.48}},
-  {{0.44, 0.36, 0.50, 0.54, 0.44, 0.50}},
-  {{0.52, 0.34, 0.54, 0.60, 0.40, 0.56}},
-  {{0.38, 0.45, 0.62, 0.72, 0.58, 0.65}},
-  {{0.48, 0.40, 0.58, 0.68, 0.52, 0.72}},
-}};
-
-constexpr std::array<std::array<double, kLaneMacroParamCount>, kLaneCount> kLaneMacroDefaults {{
-  {{0.28, 0.44, 0.34, 0.56}},
-  {{0.38, 0.56, 0.50, 0.72}},
-  {{0.20, 0.36, 0.66, 0.86}},
-  {{0.32, 0.48, 0.40, 0.54}},
-  {{0.34, 0.46, 0.42, 0.56}},
-  {{0.36, 0.50, 0.44, 0.58}},
-  {{0.28, 0.54, 0.55, 0.68}},
-  {{0.30, 0.52, 0.50, 0.62}},
-}};
-
-constexpr std::array<std::array<double, kLaneFilterParamCount>, kLaneCount> kLaneFilterDefaults {{
-  {{0.65, 0.08, 0.40, 0.70, 0.05, 0.35}},
-  {{0.68, 0.12, 0.30, 0.72, 0.08, 0.45}},
-  {{0.82, 0.06, 0.20, 0.85, 0.04, 0.30}},
-  {{0.72, 0.12, 0.38, 0.76, 0.08, 0.42}},
-  {{0.74, 0.11, 0.40, 0.78, 0.07, 0.44}},
-  {{0.70, 0.14, 0.36, 0.74, 0.09, 0.40}},
-  {{0.66, 0.18, 0.45, 0.70, 0.12, 0.52}},
-  {{0.68, 0.16, 0.42, 0.72, 0.10, 0.48}},
-}};
+#if WCSD_COMPACT_STATE
+constexpr StateEncoding kSavedStateEncoding = StateEncoding::Quantized16;
+#else
+constexpr StateEncoding kSavedStateEncoding = StateEncoding::Float64;
+#endif
 
 inline double clamp01 (double x)
 {
   return std::clamp (x, 0.0, 1.0);
 }
 
-inline double responseCurve (double x, double exponent)
-{
-  return std::pow (clamp01 (x), exponent);
-}
-
-inline double responseRange (double x, double minimum, double maximum, double exponent)
-{
-  return minimum + (responseCurve (x, exponent) * (maximum - minimum));
-}
-
 inline int32 presetIndexFromNormalized (double normalized)
 {
   const int32 maxIndex = kFactoryPresetCount - 1;
   return std::clamp (static_cast<int32> (std::lround (clamp01 (normalized) * maxIndex)), 0, maxIndex);
 }
 
-inline double normalizedFromPresetIndex (int32 presetIndex)
-{
-  if (kFactoryPresetCount <= 1)
-    return 0.0;
-  return static_cast<double> (std::clamp (presetIndex, 0, kFactoryPresetCount - 1)) /
-         static_cast<double> (kFactoryPresetCount - 1);
-}
-
-bool readV7StreamIntoDenseByParamId (IBStreamer& streamer, std::array<double, 709>& out)
+// Parameters that change what is heard from the next sample on, so process () applies each of
+// their automation points at its own offset. Transport and sequencer settings stay block-rate:
+// step times are computed once per block.
+inline bool isSampleAccurateParameter (Vst::ParamID id)
 {
-  out.fill (0.0);
-  const auto idsV7 = allParameterIdsV7 ();
-  for (int32 i = 0; i < kV7TotalParameterCount; ++i)
-  {
-    double v = 0.0;
-    if (!streamer.readDouble (v))
-      return false;
-    out[static_cast<size_t> (idsV7[static_cast<size_t> (i)])] = v;
-  }
-  return true;
+  return id == kParamMaster || id == kParamKitMorph || laneFrameDependencyMask (id) != 0 ||
+         (id >= kLaneMuteParamBase && id <= kLaneMuteMaxParamId);
 }
 
 inline int32 laneForLegacyDrumMap (int16 pitch)
@@ -170,6 +111,7 @@ WestCoastProcessor::WestCoastProcessor ()
   params_.fill (0.0);
   laneLedState_.fill (-1.0);
   laneLedFlashSamples_.fill (0);
+  tailSamples_.store (Vst::kNoTail, std::memory_order_relaxed);
 }
 
 FUnknown* WestCoastProcessor::createInstance (void*)
@@ -197,12 +139,22 @@ tresult PLUGIN_API WestCoastProcessor::initialize (FUnknown* context)
   setParam (kParamOscFilterCutoff, 0.20);
   setParam (kParamOscFilterResonance, 0.34);
   setParam (kParamOscFilterEnv, 0.46);
+  setParam (kParamKitMorph, 0.0);
+  setParam (kParamKitMorphTarget, 0.0);
+  setParam (kParamQuality, 0.0);
 
   for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
     setParam (laneOscMixParamID (lane), 1.0);
+    setParam (laneOversamplingParamID (lane), 0.0);
+  }
 
-  loadPresetByIndex (0, nullptr);
+  loadPresetByIndex (0);
+  echoPending_.reset ();
   updateLaneFramesFromParameters ();
+  defaultParams_ = params_;
+  randomizer_ = {(static_cast<uint64> (std::random_device {}()) << 32) | std::random_device {}(), 0};
+  savedState_ = {params_, loadedPreset_, randomizer_, stateGeneration_};
   return kResultOk;
 }
 
@@ -213,347 +165,57 @@ tresult PLUGIN_API WestCoastProcessor::terminate ()
 
 tresult PLUGIN_API WestCoastProcessor::setState (IBStream* state)
 {
-  if (!state)
-    return kResultFalse;
-
-  IBStreamer streamer (state, kLittleEndian);
-
-  uint32 version = 0;
-  if (!streamer.readInt32u (version))
-    return kResultFalse;
-
-  int32 savedPreset = 0;
-  if (!streamer.readInt32 (savedPreset))
-    return kResultFalse;
-  loadedPreset_ = std::clamp (savedPreset, 0, kFactoryPresetCount - 1);
-
-  const auto applyMacroDefaults = [this] () {
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-    {
-      for (int32 parameterOffset = 0; parameterOffset < kLaneMacroParamCount; ++parameterOffset)
-      {
-        setParam (laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (parameterOffset)),
-                  kLaneMacroDefaults[lane][parameterOffset]);
-      }
-    }
-  };
-
-  const auto applyFilterDefaults = [this] () {
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-    {
-      for (int32 parameterOffset = 0; parameterOffset < kLaneFilterParamCount; ++parameterOffset)
-      {
-        setParam (laneFilterParamID (lane, static_cast<LaneFilterParamOffset> (parameterOffset)),
-                  kLaneFilterDefaults[lane][parameterOffset]);
-      }
-    }
-  };
-
-  if (version == kLegacyStateVersion)
-  {
-    for (int32 param = 0; param < kPreviousGlobalParamCount; ++param)
-    {
-      double normalized = 0.0;
-      if (!streamer.readDouble (normalized))
-        return kResultFalse;
-      setParam (static_cast<Vst::ParamID> (param), normalized);
-    }
-
-    for (int32 lane = 0; lane < kLegacyLaneCount; ++lane)
-    {
-      for (int32 param = 0; param < kLaneParamCount; ++param)
-      {
-        double normalized = 0.0;
-        if (!streamer.readDouble (normalized))
-          return kResultFalse;
-        setParam (laneParamID (lane, static_cast<LaneParamOffset> (param)), normalized);
-      }
-    }
-
-    for (int32 param = 0; param < kLaneParamCount; ++param)
-    {
-      const auto offset = static_cast<LaneParamOffset> (param);
-      double value = getParam (laneParamID (3, offset));
-      if (offset == kLanePan)
-        value = clamp01 (value + 0.08);
-      setParam (laneParamID (4, offset), value);
-    }
-
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-    {
-      for (int32 param = 0; param < kLaneExtraParamCount; ++param)
-        setParam (laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (param)),
-                  kLaneExtraDefaults[lane][param]);
-    }
-    applyMacroDefaults ();
-    applyFilterDefaults ();
-
-    setParam (kParamOscFilterCutoff, 0.20);
-    setParam (kParamOscFilterResonance, 0.34);
-    setParam (kParamOscFilterEnv, 0.46);
-
-    const auto& preset = getFactoryPresets ()[loadedPreset_];
-    sequencer_.setPattern (preset.pattern);
-    updateLaneFramesFromParameters ();
-    presetPending_ = false;
-    return kResultOk;
-  }
-
-  if (version == kPreviousStateVersion)
-  {
-    constexpr int32 v2ParamCount =
-      kPreviousGlobalParamCount + (kV4LaneCount * kLaneParamCount) + (kV4LaneCount * kLaneExtraParamCount);
-    constexpr auto v2Ids = [] ()
-    {
-      std::array<Vst::ParamID, v2ParamCount> ids {};
-      int32 index = 0;
-      for (int32 i = 0; i < kPreviousGlobalParamCount; ++i)
-        ids[index++] = static_cast<Vst::ParamID> (i);
-      for (int32 lane = 0; lane < kV4LaneCount; ++lane)
-        for (int32 p = 0; p < kLaneParamCount; ++p)
-          ids[index++] = laneParamID (lane, static_cast<LaneParamOffset> (p));
-      for (int32 lane = 0; lane < kV4LaneCount; ++lane)
-        for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-          ids[index++] = laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p));
-      return ids;
-    }();
-
-    for (const auto id : v2Ids)
-    {
-      double normalized = 0.0;
-      if (!streamer.readDouble (normalized))
-        return kResultFalse;
-      setParam (id, normalized);
-    }
-    for (int32 lane = kV4LaneCount; lane < kLaneCount; ++lane)
-    {
-      for (int32 p = 0; p < kLaneParamCount; ++p)
-        setParam (laneParamID (lane, static_cast<LaneParamOffset> (p)), 0.5);
-      for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-        setParam (laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p)),
-                  kLaneExtraDefaults[lane][p]);
-    }
-    applyMacroDefaults ();
-    applyFilterDefaults ();
-
-    const auto& preset = getFactoryPresets ()[loadedPreset_];
-    sequencer_.setPattern (preset.pattern);
-    updateLaneFramesFromParameters ();
-    presetPending_ = false;
-    return kResultOk;
-  }
-
-  if (version == kV3StateVersion)
-  {
-    constexpr int32 v3ParamCount = kPreviousGlobalParamCount + (kV4LaneCount * kLaneParamCount) +
-                                   (kV4LaneCount * kLaneExtraParamCount) + (kV4LaneCount * kLaneMacroParamCount);
-    constexpr auto v3Ids = [] ()
-    {
-      std::array<Vst::ParamID, v3ParamCount> ids {};
-      int32 index = 0;
-      for (int32 i = 0; i < kPreviousGlobalParamCount; ++i)
-        ids[index++] = static_cast<Vst::ParamID> (i);
-      for (int32 lane = 0; lane < kV4LaneCount; ++lane)
-        for (int32 p = 0; p < kLaneParamCount; ++p)
-          ids[index++] = laneParamID (lane, static_cast<LaneParamOffset> (p));
-      for (int32 lane = 0; lane < kV4LaneCount; ++lane)
-        for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-          ids[index++] = laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p));
-      for (int32 lane = 0; lane < kV4LaneCount; ++lane)
-        for (int32 p = 0; p < kLaneMacroParamCount; ++p)
-          ids[index++] = laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (p));
-      return ids;
-    }();
-
-    for (const auto id : v3Ids)
-    {
-      double normalized = 0.0;
-      if (!streamer.readDouble (normalized))
-        return kResultFalse;
-      setParam (id, normalized);
-    }
-    for (int32 lane = kV4LaneCount; lane < kLaneCount; ++lane)
-    {
-      for (int32 p = 0; p < kLaneParamCount; ++p)
-        setParam (laneParamID (lane, static_cast<LaneParamOffset> (p)), 0.5);
-      for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-        setParam (laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p)),
-                  kLaneExtraDefaults[lane][p]);
-      for (int32 p = 0; p < kLaneMacroParamCount; ++p)
-        setParam (laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (p)),
-                  kLaneMacroDefaults[lane][p]);
-    }
-    applyFilterDefaults ();
-
-    setParam (kParamOscFilterCutoff, 0.20);
-    setParam (kParamOscFilterResonance, 0.34);
-    setParam (kParamOscFilterEnv, 0.46);
-
-    const auto& preset = getFactoryPresets ()[loadedPreset_];
-    sequencer_.setPattern (preset.pattern);
-    updateLaneFramesFromParameters ();
-    presetPending_ = false;
-    return kResultOk;
-  }
-
-  if (version == kV4StateVersion)
-  {
-    constexpr int32 v4ParamCount = kParamGlobalCount + (kV4LaneCount * kLaneParamCount) +
-                                   (kV4LaneCount * kLaneExtraParamCount) +
-                                   (kV4LaneCount * kLaneMacroParamCount) +
-                                   (kV4LaneCount * kLaneFilterParamCount);
-    for (int32 i = 0; i < v4ParamCount; ++i)
-    {
-      double normalized = 0.0;
-      if (!streamer.readDouble (normalized))
-        return kResultFalse;
-      setParam (allParameterIds ()[i], normalized);
-    }
-    for (int32 lane = kV4LaneCount; lane < kLaneCount; ++lane)
-    {
-      for (int32 p = 0; p < kLaneParamCount; ++p)
-        setParam (laneParamID (lane, static_cast<LaneParamOffset> (p)), 0.5);
-      for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-        setParam (laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p)),
-                  kLaneExtraDefaults[lane][p]);
-      for (int32 p = 0; p < kLaneMacroParamCount; ++p)
-        setParam (laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (p)),
-                  kLaneMacroDefaults[lane][p]);
-      for (int32 p = 0; p < kLaneFilterParamCount; ++p)
-        setParam (laneFilterParamID (lane, static_cast<LaneFilterParamOffset> (p)),
-                  kLaneFilterDefaults[lane][p]);
-    }
-    const auto& preset = getFactoryPresets ()[loadedPreset_];
-    sequencer_.setPattern (preset.pattern);
-    updateLaneFramesFromParameters ();
-    presetPending_ = false;
-    return kResultOk;
-  }
-
-  if (version == kV5StateVersion)
-  {
-    constexpr int32 v5ParamCount = kV7TotalParameterCount - kV7LaneCount - kV7LaneCount - 1;
-    const auto idsV7 = allParameterIdsV7 ();
-    for (int32 i = 0; i < v5ParamCount; ++i)
-    {
-      double normalized = 0.0;
-      if (!streamer.readDouble (normalized))
-        return kResultFalse;
-      setParam (idsV7[static_cast<size_t> (i)], normalized);
-    }
-    setParam (kParamRandomizeAmount, 1.0);
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-      setParam (laneMuteParamID (lane), 0.0);
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-      setParam (laneOscMixParamID (lane), 1.0);
-    const auto& preset = getFactoryPresets ()[loadedPreset_];
-    sequencer_.setPattern (preset.pattern);
-    updateLaneFramesFromParameters ();
-    presetPending_ = false;
-    return kResultOk;
-  }
-
-  if (version == kV6StateVersion)
-  {
-    constexpr int32 v6ParamCount = kV7TotalParameterCount - kV7LaneCount;
-    const auto idsV7 = allParameterIdsV7 ();
-    for (int32 i = 0; i < v6ParamCount; ++i)
-    {
-      double normalized = 0.0;
-      if (!streamer.readDouble (normalized))
-        return kResultFalse;
-      setParam (idsV7[static_cast<size_t> (i)], normalized);
-    }
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-      setParam (laneOscMixParamID (lane), 1.0);
-    const auto& preset = getFactoryPresets ()[loadedPreset_];
-    sequencer_.setPattern (preset.pattern);
-    updateLaneFramesFromParameters ();
-    presetPending_ = false;
-    return kResultOk;
-  }
-
-  if (version == kV7StateVersion)
-  {
-    std::array<double, 709> v7Dense {};
-    if (!readV7StreamIntoDenseByParamId (streamer, v7Dense))
-      return kResultFalse;
-
-    params_.fill (0.0);
-    auto copyLaneFromV7 = [this, &v7Dense] (int32 destLane, int32 srcLane) {
-      for (int32 p = 0; p < kLaneParamCount; ++p)
-        setParam (laneParamID (destLane, static_cast<LaneParamOffset> (p)),
-                  v7Dense[laneParamID (srcLane, static_cast<LaneParamOffset> (p))]);
-      for (int32 p = 0; p < kLaneExtraParamCount; ++p)
-        setParam (laneExtraParamID (destLane, static_cast<LaneExtraParamOffset> (p)),
-                  v7Dense[laneExtraParamID (srcLane, static_cast<LaneExtraParamOffset> (p))]);
-      for (int32 p = 0; p < kLaneMacroParamCount; ++p)
-        setParam (laneMacroParamID (destLane, static_cast<LaneMacroParamOffset> (p)),
-                  v7Dense[laneMacroParamID (srcLane, static_cast<LaneMacroParamOffset> (p))]);
-      for (int32 p = 0; p < kLaneFilterParamCount; ++p)
-        setParam (laneFilterParamID (destLane, static_cast<LaneFilterParamOffset> (p)),
-                  v7Dense[laneFilterParamID (srcLane, static_cast<LaneFilterParamOffset> (p))]);
-      setParam (laneLedParamID (destLane), v7Dense[laneLedParamID (srcLane)]);
-      setParam (laneMuteParamID (destLane), v7Dense[laneMuteParamID (srcLane)]);
-      setParam (laneOscMixParamID (destLane), v7Dense[laneOscMixParamID (srcLane)]);
-    };
-
-    for (int32 i = 0; i < kParamGlobalCount; ++i)
-      setParam (static_cast<Vst::ParamID> (i), v7Dense[static_cast<size_t> (i)]);
-    for (int32 lane = 0; lane < 6; ++lane)
-      copyLaneFromV7 (lane, lane);
-    copyLaneFromV7 (6, 8);
-    copyLaneFromV7 (7, 7);
-
-    const auto& preset = getFactoryPresets ()[loadedPreset_];
-    sequencer_.setPattern (preset.pattern);
-    updateLaneFramesFromParameters ();
-    presetPending_ = false;
-    return kResultOk;
-  }
-
-  if (version != kStateVersion)
+  ParameterStateSnapshot snapshot;
+  if (!readParameterState (state, snapshot))
     return kResultFalse;
 
-  for (const auto id : allParameterIds ())
+  // The whole engine image is built here, on the host's thread; process () only swaps it in.
+  // Parameters the saved version did not know start from their initialize () values.
+  StateImage& image = stateHandoff_.beginWrite ();
+  image.params = defaultParams_;
+  forEachAssignedParam (snapshot, [&image] (Vst::ParamID id, double normalized)
   {
-    double normalized = 0.0;
-    if (!streamer.readDouble (normalized))
-      return kResultFalse;
-    setParam (id, normalized);
-  }
+    image.params[denseParamIndex (id)] = clamp01 (normalized);
+  });
+  image.presetIndex = std::clamp (snapshot.presetIndex, 0, kFactoryPresetCount - 1);
+  image.randomizer = snapshot.randomizer;
+  image.hasRandomizer = snapshot.hasRandomizer;
+  image.generation = ++stateGeneration_;
+  buildLaneFrames (image.params, kAllLanesMask, image.frames);
+  stateHandoff_.publish ();
 
   for (int32 lane = 0; lane < kLaneCount; ++lane)
   {
-    if (getParam (laneOscMixParamID (lane)) < 1e-6)
-      setParam (laneOscMixParamID (lane), 1.0);
+    const auto slot = static_cast<size_t> (denseParamIndex (laneOversamplingParamID (lane)));
+    hostOversampling_[lane] = oversamplingFromNormalized (image.params[slot]);
   }
-
-  const auto& preset = getFactoryPresets ()[loadedPreset_];
-  sequencer_.setPattern (preset.pattern);
-  updateLaneFramesFromParameters ();
-  presetPending_ = false;
+  latencySamples_.store (static_cast<uint32> (bankOversamplingLatency (hostOversampling_)), std::memory_order_relaxed);
+
+  // A getState () before process () picks the image up saves it as set, not the previous state.
+  savedState_.params = image.params;
+  savedState_.presetIndex = image.presetIndex;
+  if (image.hasRandomizer)
+    savedState_.randomizer = image.randomizer;
+  savedState_.stateGeneration = image.generation;
+
+  // While inactive no process () call can run, so apply it now for a getState () that follows.
+  if (!active_.load (std::memory_order_acquire))
+    applyPendingState ();
   return kResultOk;
 }
 
 tresult PLUGIN_API WestCoastProcessor::getState (IBStream* state)
 {
-  if (!state)
-    return kResultFalse;
-
-  IBStreamer streamer (state, kLittleEndian);
-  if (!streamer.writeInt32u (kStateVersion))
-    return kResultFalse;
-  if (!streamer.writeInt32 (loadedPreset_))
-    return kResultFalse;
-
-  for (const auto id : allParameterIds ())
+  // Snapshots taken before process () applied the latest setState () are older than savedState_.
+  savedStateHandoff_.consume ([this] (const SavedState& published)
   {
-    if (!streamer.writeDouble (getParam (id)))
-      return kResultFalse;
-  }
-
-  return kResultOk;
+    if (published.stateGeneration == stateGeneration_)
+      savedState_ = published;
+  });
+  const SavedState& saved = savedState_;
+  return writeParameterState (state, saved.presetIndex, saved.params, saved.randomizer, kSavedStateEncoding)
+           ? kResultOk
+           : kResultFalse;
 }
 
 tresult PLUGIN_API WestCoastProcessor::setBusArrangements (Vst::SpeakerArrangement* inputs, int32 numIns,
@@ -573,8 +235,12 @@ tresult PLUGIN_API WestCoastProcessor::setupProcessing (Vst::ProcessSetup& setup
     return result;
 
   sequencer_.setSampleRate (setup.sampleRate);
-  for (auto& voice : voices_)
-    voice.setSampleRate (setup.sampleRate);
+  voices_.setSampleRate (setup.sampleRate);
+  voicesFloat_.setSampleRate (setup.sampleRate);
+  voices_.setControlInterval (VoiceDsp::controlIntervalFor (setup.sampleRate));
+  voicesFloat_.setControlInterval (VoiceDsp::controlIntervalFor (setup.sampleRate));
+  floatEngine_ = setup.symbolicSampleSize == Vst::kSample32;
+  laneMix_.setSampleRate (setup.sampleRate);
   ledFlashDurationSamples_ = std::max<int32> (1, static_cast<int32> (std::lround (setup.sampleRate * 0.045)));
   return kResultOk;
 }
@@ -583,14 +249,30 @@ tresult PLUGIN_API WestCoastProcessor::setActive (TBool state)
 {
   if (state)
     resetEngine ();
+  active_.store (state != 0, std::memory_order_release);
+  if (!state)
+    applyPendingState ();
   return AudioEffect::setActive (state);
 }
 
+template <typename Sample>
+DrumVoiceBankT<Sample>& WestCoastProcessor::voiceBank ()
+{
+  if constexpr (std::is_same_v<Sample, float>)
+    return voicesFloat_;
+  else
+    return voices_;
+}
+
 tresult PLUGIN_API WestCoastProcessor::process (Vst::ProcessData& data)
 {
-  processParameterChanges (data.inputParameterChanges, data.outputParameterChanges);
+  // The host's floating-point mode is restored on return.
+  const ScopedFlushDenormals flushDenormals;
+  applyPendingState ();
+  processParameterChanges (data.inputParameterChanges, data.outputParameterChanges, data.numSamples);
   if (presetPending_)
-    loadPresetByIndex (loadedPreset_, data.outputParameterChanges);
+    loadPresetByIndex (loadedPreset_);
+  echoParameters (data.outputParameterChanges);
 
   bool hostPlaying = false;
   bool hostTempoValid = false;
@@ -619,11 +301,14 @@ tresult PLUGIN_API WestCoastProcessor::process (Vst::ProcessData& data)
   if (followTransport && hostProjectTimeValid && hostPlaying)
     sequencer_.syncToHost (hostPpq, hostPlaying);
 
-  struct MidiTrigger {
-    int32 sampleOffset;
-    int32 lane;
-  };
-  std::vector<MidiTrigger> midiTriggers;
+  refreshLaneMix ();
+  refreshOversampling ();
+
+  // Muted or silent lanes ignore hits. Without automation inside the block that is known now and
+  // they never reach the queue; otherwise it is checked when the hit is applied.
+  const bool filterTriggers = parameterQueue_.empty ();
+  auto triggerable = [&] (int32 lane) { return !filterTriggers || laneMix_.isActive (lane); };
+  triggerQueue_.clear ();
   if (data.inputEvents)
   {
     const int32 eventCount = data.inputEvents->getEventCount ();
@@ -636,21 +321,31 @@ tresult PLUGIN_API WestCoastProcessor::process (Vst::ProcessData& data)
         continue;
 
       const int32 lane = laneForMidiPitch (event.noteOn.pitch);
-      if (lane >= 0 && lane < kLaneCount)
-      {
-        const int32 offset = std::clamp (event.sampleOffset, 0, data.numSamples - 1);
-        midiTriggers.push_back ({offset, lane});
-      }
+      if (lane >= 0 && lane < kLaneCount && triggerable (lane))
+        triggerQueue_.push ({std::clamp (event.sampleOffset, 0, data.numSamples - 1), lane});
     }
   }
 
   if (data.numOutputs == 0 || data.outputs == nullptr || data.numSamples <= 0)
+  {
+    flushParameterEvents ();
     return kResultOk;
+  }
 
-  const double masterGain = std::pow (clamp01 (getParam (kParamMaster)), 1.35);
+  // Sequencer hits join the MIDI ones on the same timeline; at a shared offset MIDI goes first.
+  sequencer_.collectTriggers (data.numSamples, [&] (int32 sampleOffset, int32 lane)
+  {
+    if (triggerable (lane))
+      triggerQueue_.push ({sampleOffset, lane});
+  });
+  triggerQueue_.sort ();
+
+  double masterGain = std::pow (clamp01 (getParam (kParamMaster)), 1.35);
   // Single gentle ceiling after summing; avoid stacking heavy tanh with per-voice softClip.
   constexpr double kBusHeadroom = 0.52;
-  std::array<bool, kLaneCount> triggers {};
+  // Voices render in sub-blocks that end at the next trigger (or after kVoiceBlockSize samples),
+  // so every lane runs its block kernel instead of one call per sample.
+  constexpr int32 kVoiceBlockSize = 64;
 
   auto render = [&] (auto** outChannels)
   {
@@ -659,72 +354,160 @@ tresult PLUGIN_API WestCoastProcessor::process (Vst::ProcessData& data)
     auto* left = outChannels[0];
     auto* right = (data.outputs[0].numChannels > 1) ? outChannels[1] : outChannels[0];
 
-    for (int32 sampleIndex = 0; sampleIndex < data.numSamples; ++sampleIndex)
+    auto& voices = voiceBank<SampleType> ();
+    voices.setAntiAliasing (getParam (kParamQuality) >= 0.5);
+    std::array<LaneArray<SampleType>, kVoiceBlockSize> laneBlock {};
+    std::array<SampleType, kVoiceBlockSize> mixL {};
+    std::array<SampleType, kVoiceBlockSize> mixR {};
+
+    auto renderSegment = [&] (int32 start, int32 end)
     {
-      for (const auto& mt : midiTriggers)
+      const int32 length = end - start;
+      voices.processBlock (laneBlock.data (), length, laneMix_.activeMask ());
+      laneMix_.mix (laneBlock.data (), length, mixL.data (), mixR.data ());
+
+      const auto headroom = static_cast<SampleType> (kBusHeadroom);
+      const auto gain = static_cast<SampleType> (masterGain);
+      for (int32 i = 0; i < length; ++i)
       {
-        if (mt.sampleOffset == sampleIndex)
-        {
-          const int32 lane = mt.lane;
-          const bool muted = getParam (laneMuteParamID (lane)) > 0.5;
-          if (!muted && laneFrames_[lane].outputLevel > 1e-6)
-          {
-            voices_[lane].trigger (laneFrames_[lane]);
-            laneLedFlashSamples_[lane] = ledFlashDurationSamples_;
-          }
-        }
+        const SampleType gL = mixL[i] * headroom * gain;
+        const SampleType gR = mixR[i] * headroom * gain;
+        left[start + i] = gL / (SampleType (1) + std::abs (gL) * SampleType (0.55));
+        right[start + i] = gR / (SampleType (1) + std::abs (gR) * SampleType (0.55));
       }
 
-      sequencer_.processSample (triggers);
       for (int32 lane = 0; lane < kLaneCount; ++lane)
+        laneLedFlashSamples_[lane] = std::max (0, laneLedFlashSamples_[lane] - length);
+    };
+
+    // Automation points applied since the last render: rebuild what they feed before going on.
+    bool automationPending = false;
+    auto applyAutomation = [&] ()
+    {
+      if (!automationPending)
+        return;
+      updateLaneFramesFromParameters ();
+      refreshLaneMix ();
+      masterGain = std::pow (clamp01 (getParam (kParamMaster)), 1.35);
+      voices.setAntiAliasing (getParam (kParamQuality) >= 0.5);
+      automationPending = false;
+    };
+
+    // The kit morph glides from its last automation point to the next queued one: the position is
+    // interpolated every control interval of the voice bank, so sounding hits are retuned along a
+    // line instead of jumping at each point.
+    auto findMorphPoint = [&] (int32 from)
+    {
+      while (from < parameterQueue_.size () && parameterQueue_[from].id != kParamKitMorph)
+        ++from;
+      return from;
+    };
+    int32 nextMorphIndex = findMorphPoint (0);
+    int32 morphFromOffset = 0;
+    double morphFrom = getParam (kParamKitMorph);
+
+    int32 segmentStart = 0;
+    auto renderUntil = [&] (int32 end)
+    {
+      applyAutomation ();
+      while (segmentStart < end)
       {
-        const bool muted = getParam (laneMuteParamID (lane)) > 0.5;
-        if (triggers[lane] && laneFrames_[lane].outputLevel > 1e-6 && !muted)
+        int32 segmentEnd = std::min (end, segmentStart + kVoiceBlockSize);
+        if (nextMorphIndex < parameterQueue_.size ())
         {
-          voices_[lane].trigger (laneFrames_[lane]);
-          laneLedFlashSamples_[lane] = ledFlashDurationSamples_;
+          const ParameterEvent& morphTo = parameterQueue_[nextMorphIndex];
+          const double position = static_cast<double> (segmentStart - morphFromOffset) /
+                                  static_cast<double> (morphTo.sampleOffset - morphFromOffset);
+          setParam (kParamKitMorph, morphFrom + (clamp01 (morphTo.value) - morphFrom) * position);
+          refreshLaneMix ();
+          segmentEnd = std::min (segmentEnd, segmentStart + voices.controlInterval ());
         }
+        renderSegment (segmentStart, segmentEnd);
+        segmentStart = segmentEnd;
       }
+    };
 
-      double frameL = 0.0;
-      double frameR = 0.0;
-      for (int32 lane = 0; lane < kLaneCount; ++lane)
+    // Walk automation points and hits in time order; at a shared offset the automation lands
+    // first, so a hit sees the value automated onto its sample.
+    int32 triggerIndex = 0;
+    int32 parameterIndex = 0;
+    while (triggerIndex < triggerQueue_.size () || parameterIndex < parameterQueue_.size ())
+    {
+      if (parameterIndex < parameterQueue_.size () &&
+          (triggerIndex >= triggerQueue_.size () ||
+           parameterQueue_[parameterIndex].sampleOffset <= triggerQueue_[triggerIndex].sampleOffset))
       {
-        const bool muted = getParam (laneMuteParamID (lane)) > 0.5;
-        if (muted || laneFrames_[lane].outputLevel < 1e-6)
-          continue;
-        const double sample = voices_[lane].process ();
-        const double pan = std::clamp (laneFrames_[lane].pan, -1.0, 1.0);
-        const double gainL = std::sqrt (0.5 * (1.0 - pan));
-        const double gainR = std::sqrt (0.5 * (1.0 + pan));
-        frameL += sample * gainL;
-        frameR += sample * gainR;
+        const ParameterEvent& event = parameterQueue_[parameterIndex++];
+        renderUntil (event.sampleOffset);
+        setParam (event.id, event.value);
+        automationPending = true;
+        if (event.id == kParamKitMorph)
+        {
+          morphFromOffset = event.sampleOffset;
+          morphFrom = getParam (kParamKitMorph);
+          nextMorphIndex = findMorphPoint (parameterIndex);
+        }
+        continue;
       }
 
-      const double gL = frameL * kBusHeadroom * masterGain;
-      const double gR = frameR * kBusHeadroom * masterGain;
-      const double busL = gL / (1.0 + std::abs (gL) * 0.55);
-      const double busR = gR / (1.0 + std::abs (gR) * 0.55);
-
-      left[sampleIndex] = static_cast<SampleType> (busL);
-      right[sampleIndex] = static_cast<SampleType> (busR);
-
-      for (int32 lane = 0; lane < kLaneCount; ++lane)
-      {
-        if (laneLedFlashSamples_[lane] > 0)
-          --laneLedFlashSamples_[lane];
-      }
+      const TriggerEvent& event = triggerQueue_[triggerIndex++];
+      renderUntil (event.sampleOffset);
+      if (!laneMix_.isActive (event.lane))
+        continue;
+      voices.trigger (event.lane, kitFrames_[event.lane]);
+      laneLedFlashSamples_[event.lane] = ledFlashDurationSamples_;
     }
+    renderUntil (data.numSamples);
+    parameterQueue_.clear ();
+    flushParameterEvents ();
+  };
+
+  // Nothing can sound this block: clear the bus and flag it silent instead of running the voices.
+  const uint32 sounding = floatEngine_ ? voicesFloat_.activeMask () : voices_.activeMask ();
+  const bool idle = sounding == 0 && triggerQueue_.empty ();
+  auto clear = [&] (auto** outChannels)
+  {
+    for (int32 channel = 0; channel < data.outputs[0].numChannels; ++channel)
+      std::memset (outChannels[channel], 0, sizeof (outChannels[channel][0]) * data.numSamples);
   };
 
   if (data.symbolicSampleSize == Vst::kSample32)
-    render (data.outputs[0].channelBuffers32);
+  {
+    if (idle)
+      clear (data.outputs[0].channelBuffers32);
+    else
+      render (data.outputs[0].channelBuffers32);
+  }
   else if (data.symbolicSampleSize == Vst::kSample64)
-    render (data.outputs[0].channelBuffers64);
+  {
+    if (idle)
+      clear (data.outputs[0].channelBuffers64);
+    else
+      render (data.outputs[0].channelBuffers64);
+  }
   else
     return kResultFalse;
 
-  data.outputs[0].silenceFlags = 0;
+  if (idle)
+  {
+    flushParameterEvents ();
+    data.outputs[0].silenceFlags = (static_cast<uint64> (1) << data.outputs[0].numChannels) - 1;
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+      laneLedFlashSamples_[lane] = std::max (0, laneLedFlashSamples_[lane] - data.numSamples);
+  }
+  else
+    data.outputs[0].silenceFlags = 0;
+
+  // A running sequencer keeps producing hits without any input. Otherwise the tail covers the
+  // longest hit the current kit can play, idle or not, and any ringing voice beyond that.
+  if (kitTailDirty_)
+  {
+    kitTailSamples_ = voices_.tailSamplesFor (kitFrames_);
+    kitTailDirty_ = false;
+  }
+  const uint32 voiceTail = floatEngine_ ? voicesFloat_.tailSamples () : voices_.tailSamples ();
+  tailSamples_.store (sequencer_.isRunning () ? Vst::kInfiniteTail : std::max (kitTailSamples_, voiceTail),
+                      std::memory_order_relaxed);
 
   if (data.outputParameterChanges)
   {
@@ -739,104 +522,225 @@ tresult PLUGIN_API WestCoastProcessor::process (Vst::ProcessData& data)
     }
   }
 
+  publishSavedState ();
+  return kResultOk;
+}
+
+void WestCoastProcessor::refreshLaneMix ()
+{
+  if (!laneMixDirty_)
+    return;
+
+  const double kitMorph = getParam (kParamKitMorph);
+  if (kitMorph <= 0.0)
+  {
+    kitFrames_ = laneFrames_;
+  }
+  else
+  {
+    const int32 target = presetIndexFromNormalized (getParam (kParamKitMorphTarget));
+    if (target != kitBankBPreset_)
+    {
+      packLaneFrames (getCompiledPresets ()[target].frames, kitBankB_);
+      kitBankBPreset_ = target;
+    }
+    packLaneFrames (laneFrames_, kitBankA_);
+    blendLaneFrames (kitBankA_, kitBankB_, kitMorph, kitFrames_);
+  }
+
+  // Hits already sounding follow the morph; other frame edits only reach the next hit. Only the
+  // bank that renders has hits sounding.
+  if (kitMorphMoved_)
+  {
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+    {
+      if (floatEngine_)
+        voicesFloat_.retune (lane, kitFrames_[lane]);
+      else
+        voices_.retune (lane, kitFrames_[lane]);
+    }
+    kitMorphMoved_ = false;
+  }
+
+  uint32 mutedMask = 0;
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    if (getParam (laneMuteParamID (lane)) > 0.5)
+      mutedMask |= 1u << lane;
+  }
+  laneMix_.update (kitFrames_, mutedMask);
+  laneMixDirty_ = false;
+  kitTailDirty_ = true;
+}
+
+void WestCoastProcessor::refreshOversampling ()
+{
+  if (!oversamplingDirty_)
+    return;
+
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    const int32 factor = oversamplingFromNormalized (getParam (laneOversamplingParamID (lane)));
+    voices_.setOversampling (lane, factor);
+    voicesFloat_.setOversampling (lane, factor);
+  }
+  oversamplingDirty_ = false;
+  kitTailDirty_ = true;
+}
+
+void WestCoastProcessor::flushParameterEvents ()
+{
+  if (parameterQueue_.empty () && parameterOverflow_.empty ())
+    return;
+
+  for (int32 eventIndex = 0; eventIndex < parameterQueue_.size (); ++eventIndex)
+    setParam (parameterQueue_[eventIndex].id, parameterQueue_[eventIndex].value);
+  parameterQueue_.clear ();
+  for (int32 eventIndex = 0; eventIndex < parameterOverflow_.size (); ++eventIndex)
+    setParam (parameterOverflow_[eventIndex].id, parameterOverflow_[eventIndex].value);
+  parameterOverflow_.clear ();
+  updateLaneFramesFromParameters ();
+}
+
+uint32 PLUGIN_API WestCoastProcessor::getTailSamples ()
+{
+  return tailSamples_.load (std::memory_order_relaxed);
+}
+
+uint32 PLUGIN_API WestCoastProcessor::getLatencySamples ()
+{
+  return latencySamples_.load (std::memory_order_relaxed);
+}
+
+tresult PLUGIN_API WestCoastProcessor::notify (Vst::IMessage* message)
+{
+  if (!message || !FIDStringsEqual (message->getMessageID (), kOversamplingMessageId))
+    return AudioEffect::notify (message);
+
+  int64 lane = 0;
+  int64 factor = 1;
+  Vst::IAttributeList* attributes = message->getAttributes ();
+  if (!attributes || attributes->getInt (kOversamplingMessageLane, lane) != kResultOk ||
+      attributes->getInt (kOversamplingMessageFactor, factor) != kResultOk || lane < 0 || lane >= kLaneCount)
+    return kInvalidArgument;
+
+  // The factor itself reaches process () as a parameter change; only the latency is taken here.
+  hostOversampling_[static_cast<size_t> (lane)] = static_cast<int32> (factor);
+  latencySamples_.store (static_cast<uint32> (bankOversamplingLatency (hostOversampling_)), std::memory_order_relaxed);
   return kResultOk;
 }
 
 void WestCoastProcessor::resetEngine ()
 {
   sequencer_.reset ();
-  for (auto& voice : voices_)
-    voice.reset ();
+  voices_.reset ();
+  voicesFloat_.reset ();
+  laneMix_.reset ();
+  laneMixDirty_ = true;
   laneLedState_.fill (-1.0);
   laneLedFlashSamples_.fill (0);
 }
 
-void WestCoastProcessor::loadPresetByIndex (int32 presetIndex, Vst::IParameterChanges* outputChanges)
+void WestCoastProcessor::applyPendingState ()
 {
-  const auto& presets = getFactoryPresets ();
-  loadedPreset_ = std::clamp (presetIndex, 0, kFactoryPresetCount - 1);
-  const auto& preset = presets[loadedPreset_];
+  stateHandoff_.consume ([this] (const StateImage& image)
+  {
+    params_ = image.params;
+    laneFrames_ = image.frames;
+    dirtyLaneFrames_ = 0;
+    laneMixDirty_ = true;
+    oversamplingDirty_ = true;
+    loadedPreset_ = image.presetIndex;
+    if (image.hasRandomizer)
+      randomizer_ = image.randomizer;
+    appliedStateGeneration_ = image.generation;
+    savedStateDirty_ = true;
+    sequencer_.setPattern (getFactoryPresets ()[loadedPreset_].pattern);
+    presetPending_ = false;
+  });
+  refreshOversampling ();
+}
 
-  setParam (kParamMaster, preset.master);
-  setParam (kParamInternalTempo, preset.internalTempo);
-  setParam (kParamSwing, preset.swing);
-  setParam (kParamPresetSelect, normalizedFromPresetIndex (loadedPreset_));
+void WestCoastProcessor::publishSavedState ()
+{
+  if (!savedStateDirty_)
+    return;
 
-  pushParamChange (outputChanges, kParamMaster, getParam (kParamMaster));
-  pushParamChange (outputChanges, kParamInternalTempo, getParam (kParamInternalTempo));
-  pushParamChange (outputChanges, kParamSwing, getParam (kParamSwing));
-  pushParamChange (outputChanges, kParamPresetSelect, getParam (kParamPresetSelect));
+  SavedState& saved = savedStateHandoff_.beginWrite ();
+  saved.params = params_;
+  saved.presetIndex = loadedPreset_;
+  saved.randomizer = randomizer_;
+  saved.stateGeneration = appliedStateGeneration_;
+  savedStateHandoff_.publish ();
+  savedStateDirty_ = false;
+}
 
-  for (int32 lane = 0; lane < kLaneCount; ++lane)
-  {
-    const auto& lanePreset = preset.lanes[lane];
-    const double transientDecayMacro = std::clamp (0.18 + (lanePreset.decay * 0.62), 0.0, 1.0);
-    const double transientMixMacro = std::clamp (0.24 + (lanePreset.transientAttack * 0.70), 0.0, 1.0);
-    const double noiseResMacro = std::clamp (0.20 + (lanePreset.snap * 0.68), 0.0, 1.0);
-    const double noiseEnvMacro = std::clamp (0.28 + (lanePreset.noiseDecay * 0.56), 0.0, 1.0);
-
-    setParam (laneParamID (lane, kLaneTune), lanePreset.tune);
-    setParam (laneParamID (lane, kLaneDecay), lanePreset.decay);
-    setParam (laneParamID (lane, kLaneFold), lanePreset.fold);
-    setParam (laneParamID (lane, kLaneFm), lanePreset.fm);
-    setParam (laneParamID (lane, kLaneNoise), lanePreset.noise);
-    setParam (laneParamID (lane, kLaneDrive), lanePreset.drive);
-    setParam (laneParamID (lane, kLaneLevel), lanePreset.level);
-    setParam (laneParamID (lane, kLanePan), lanePreset.pan);
-    setParam (laneExtraParamID (lane, kLanePitchEnvAmount), lanePreset.pitchEnvAmount);
-    setParam (laneExtraParamID (lane, kLanePitchEnvDecay), lanePreset.pitchEnvDecay);
-    setParam (laneExtraParamID (lane, kLaneTransientAttack), lanePreset.transientAttack);
-    setParam (laneExtraParamID (lane, kLaneNoiseTone), lanePreset.noiseTone);
-    setParam (laneExtraParamID (lane, kLaneNoiseDecay), lanePreset.noiseDecay);
-    setParam (laneExtraParamID (lane, kLaneSnap), lanePreset.snap);
-    setParam (laneMacroParamID (lane, kLaneTransientDecay), transientDecayMacro);
-    setParam (laneMacroParamID (lane, kLaneTransientMix), transientMixMacro);
-    setParam (laneMacroParamID (lane, kLaneNoiseResonance), noiseResMacro);
-    setParam (laneMacroParamID (lane, kLaneNoiseEnvAmount), noiseEnvMacro);
-    setParam (laneFilterParamID (lane, kLaneOscFilterCutoff), lanePreset.oscFilterCutoff);
-    setParam (laneFilterParamID (lane, kLaneOscFilterRes), lanePreset.oscFilterRes);
-    setParam (laneFilterParamID (lane, kLaneOscFilterEnv), lanePreset.oscFilterEnv);
-    setParam (laneFilterParamID (lane, kLaneTransFilterCutoff), lanePreset.transFilterCutoff);
-    setParam (laneFilterParamID (lane, kLaneTransFilterRes), lanePreset.transFilterRes);
-    setParam (laneFilterParamID (lane, kLaneTransFilterEnv), lanePreset.transFilterEnv);
-
-    pushParamChange (outputChanges, laneParamID (lane, kLaneTune), lanePreset.tune);
-    pushParamChange (outputChanges, laneParamID (lane, kLaneDecay), lanePreset.decay);
-    pushParamChange (outputChanges, laneParamID (lane, kLaneFold), lanePreset.fold);
-    pushParamChange (outputChanges, laneParamID (lane, kLaneFm), lanePreset.fm);
-    pushParamChange (outputChanges, laneParamID (lane, kLaneNoise), lanePreset.noise);
-    pushParamChange (outputChanges, laneParamID (lane, kLaneDrive), lanePreset.drive);
-    pushParamChange (outputChanges, laneParamID (lane, kLaneLevel), lanePreset.level);
-    pushParamChange (outputChanges, laneParamID (lane, kLanePan), lanePreset.pan);
-    pushParamChange (outputChanges, laneExtraParamID (lane, kLanePitchEnvAmount), lanePreset.pitchEnvAmount);
-    pushParamChange (outputChanges, laneExtraParamID (lane, kLanePitchEnvDecay), lanePreset.pitchEnvDecay);
-    pushParamChange (outputChanges, laneExtraParamID (lane, kLaneTransientAttack), lanePreset.transientAttack);
-    pushParamChange (outputChanges, laneExtraParamID (lane, kLaneNoiseTone), lanePreset.noiseTone);
-    pushParamChange (outputChanges, laneExtraParamID (lane, kLaneNoiseDecay), lanePreset.noiseDecay);
-    pushParamChange (outputChanges, laneExtraParamID (lane, kLaneSnap), lanePreset.snap);
-    pushParamChange (outputChanges, laneMacroParamID (lane, kLaneTransientDecay), transientDecayMacro);
-    pushParamChange (outputChanges, laneMacroParamID (lane, kLaneTransientMix), transientMixMacro);
-    pushParamChange (outputChanges, laneMacroParamID (lane, kLaneNoiseResonance), noiseResMacro);
-    pushParamChange (outputChanges, laneMacroParamID (lane, kLaneNoiseEnvAmount), noiseEnvMacro);
-    pushParamChange (outputChanges, laneFilterParamID (lane, kLaneOscFilterCutoff), lanePreset.oscFilterCutoff);
-    pushParamChange (outputChanges, laneFilterParamID (lane, kLaneOscFilterRes), lanePreset.oscFilterRes);
-    pushParamChange (outputChanges, laneFilterParamID (lane, kLaneOscFilterEnv), lanePreset.oscFilterEnv);
-    pushParamChange (outputChanges, laneFilterParamID (lane, kLaneTransFilterCutoff), lanePreset.transFilterCutoff);
-    pushParamChange (outputChanges, laneFilterParamID (lane, kLaneTransFilterRes), lanePreset.transFilterRes);
-    pushParamChange (outputChanges, laneFilterParamID (lane, kLaneTransFilterEnv), lanePreset.transFilterEnv);
+void WestCoastProcessor::loadPresetByIndex (int32 presetIndex)
+{
+  loadedPreset_ = std::clamp (presetIndex, 0, kFactoryPresetCount - 1);
+  savedStateDirty_ = true;
+  const CompiledPreset& preset = getCompiledPresets ()[loadedPreset_];
 
-    setParam (laneOscMixParamID (lane), 1.0);
-    pushParamChange (outputChanges, laneOscMixParamID (lane), 1.0);
+  for (const int16 slot : getPresetParamSlots ())
+    params_[slot] = preset.params[slot];
+
+  // The precompiled frames hold at the compiled morph, with only their body filter following the
+  // global osc filter. Off that morph every field moves and the lanes are rebuilt.
+  if (compiledMorphMatches (params_))
+  {
+    laneFrames_ = preset.frames;
+    if (!compiledFramesMatch (params_))
+      applyGlobalOscFilter (params_, kAllLanesMask, laneFrames_);
+    dirtyLaneFrames_ = 0;
   }
+  else
+  {
+    dirtyLaneFrames_ = kAllLanesMask;
+  }
+  laneMixDirty_ = true;
 
-  sequencer_.setPattern (preset.pattern);
+  sequencer_.setPattern (*preset.pattern);
   updateLaneFramesFromParameters ();
+  queueParameterEcho (getPresetParamSlots ().data (), kPresetParamSlotCount);
   presetPending_ = false;
 }
 
+void WestCoastProcessor::randomizeParameters ()
+{
+  const double amount = std::abs (getParam (kParamRandomizeAmount) - 0.5) * 2.0;
+  WestCoastDrumSynth::randomizeParameters (params_, amount, randomizer_);
+  dirtyLaneFrames_ = kAllLanesMask;
+  savedStateDirty_ = true;
+  queueParameterEcho (getRandomizedParamSlots ().data (), kRandomizedParamSlotCount);
+}
+
+void WestCoastProcessor::queueParameterEcho (const int16* slots, int32 numSlots)
+{
+  for (int32 i = 0; i < numSlots; ++i)
+    echoPending_.set (static_cast<size_t> (slots[i]));
+}
+
+void WestCoastProcessor::echoParameters (Vst::IParameterChanges* outputChanges)
+{
+  if (!outputChanges || echoPending_.none ())
+    return;
+
+  int32 numSent = 0;
+  for (int32 slot = 0; slot < kDenseParameterCount && numSent < kParamEchoChangesPerBlock; ++slot)
+  {
+    if (!echoPending_.test (static_cast<size_t> (slot)))
+      continue;
+    echoPending_.reset (static_cast<size_t> (slot));
+    pushParamChange (outputChanges, kDenseParamIdMap[slot], params_[slot]);
+    ++numSent;
+  }
+}
+
 void WestCoastProcessor::processParameterChanges (Vst::IParameterChanges* changes,
-                                                  Vst::IParameterChanges* outputChanges)
+                                                  Vst::IParameterChanges* outputChanges, int32 numSamples)
 {
+  parameterQueue_.clear ();
+  parameterOverflow_.clear ();
   if (!changes)
     return;
 
@@ -858,22 +762,31 @@ void WestCoastProcessor::processParameterChanges (Vst::IParameterChanges* change
 
     const auto paramId = queue->getParameterId ();
 
-    if (paramId == kParamRandomize && value > 0.5 && getParam (kParamRandomize) <= 0.5)
+    // Points inside the block are queued for process (), points at its start apply right away.
+    // Should the queue run out of room, the points that fit still play and the final value is
+    // applied once the whole block has rendered, so it is never overwritten by earlier points.
+    if (sampleOffset > 0 && numSamples > 1 && isSampleAccurateParameter (paramId))
     {
-      const double amount = std::abs (getParam (kParamRandomizeAmount) - 0.5) * 2.0;
-      std::uniform_real_distribution<double> dist (-1.0, 1.0);
-      for (const auto id : allParameterIds ())
+      const Vst::ParamValue finalValue = value;
+      bool overflowed = false;
+      for (int32 pointIdx = 0; pointIdx < pointCount && !overflowed; ++pointIdx)
       {
-        if (id == kParamRandomize || id == kParamRandomizeAmount || id == kParamPresetSelect ||
-            id == kParamRun || id == kParamFollowTransport || isLaneLedParamID (id))
-          continue;
-        if (id >= kLaneMuteParamBase && id <= kLaneMuteMaxParamId)
+        if (queue->getPoint (pointIdx, sampleOffset, value) != kResultOk)
           continue;
-        const double delta = dist (rng_) * amount * 0.35;
-        setParam (id, clamp01 (getParam (id) + delta));
-        if (outputChanges)
-          pushParamChange (outputChanges, id, getParam (id));
+        const int32 offset = std::clamp (sampleOffset, 0, numSamples - 1);
+        if (offset == 0)
+          setParam (paramId, value);
+        else
+          overflowed = !parameterQueue_.push ({offset, paramId, value});
       }
+      if (overflowed)
+        parameterOverflow_.push ({numSamples, paramId, finalValue});
+      continue;
+    }
+
+    if (paramId == kParamRandomize && value > 0.5 && getParam (kParamRandomize) <= 0.5)
+    {
+      randomizeParameters ();
       setParam (kParamRandomize, 0.0);
       if (outputChanges)
         pushParamChange (outputChanges, kParamRandomize, 0.0);
@@ -890,6 +803,7 @@ void WestCoastProcessor::processParameterChanges (Vst::IParameterChanges* change
     }
   }
 
+  parameterQueue_.sort ();
   updateLaneFramesFromParameters ();
 
   if (presetPending_ && outputChanges)
@@ -898,140 +812,14 @@ void WestCoastProcessor::processParameterChanges (Vst::IParameterChanges* change
 
 void WestCoastProcessor::updateLaneFramesFromParameters ()
 {
-  // Tuning workflow: adjust per-lane scale tables below (kTransient*Scale, kOsc*, kNoise*, etc.),
-  // then lane defaults in kLaneExtraDefaults / kLaneMacroDefaults / kLaneFilterDefaults at file top.
-  // FactoryPresets.cpp controls preset snapshots; morph uses getMorphedParam (center = stored value).
-
-  // Kick, Snare, Hat, PercA1, PercA2 (low bass), PercB1, Clap, RimShot
-  static constexpr std::array<double, kLaneCount> kBaseFrequencies {
-    52.0, 185.0, 3800.0, 45.0, 65.0, 520.0, 650.0, 950.0};
-  static constexpr std::array<LaneCharacter, kLaneCount> kLaneCharacters {
-    LaneCharacter::Kick, LaneCharacter::Snare, LaneCharacter::Hat,
-    LaneCharacter::PercA, LaneCharacter::PercA, LaneCharacter::PercB,
-    LaneCharacter::Clap, LaneCharacter::RimShot};
-  static constexpr std::array<double, kLaneCount> kPitchEnvScale {
-    1.0, 0.60, 0.28, 0.85, 0.82, 0.72, 0.48, 0.58};
-  static constexpr std::array<double, kLaneCount> kTransientAttackScale {
-    1.0, 0.92, 0.74, 0.90, 0.88, 0.92, 0.88, 0.95};
-  static constexpr std::array<double, kLaneCount> kTransientDecayScale {
-    1.4, 1.16, 0.68, 1.3, 1.25, 0.94, 0.78, 0.85};
-  static constexpr std::array<double, kLaneCount> kTransientLevelScale {
-    1.35, 1.10, 0.88, 1.25, 1.20, 1.02, 1.12, 1.08};
-  static constexpr std::array<double, kLaneCount> kNoiseLevelScale {
-    1.05, 2.05, 1.65, 1.35, 1.38, 1.42, 1.75, 1.55};
-  static constexpr std::array<double, kLaneCount> kNoiseDecayScale {
-    0.82, 1.58, 0.94, 1.15, 1.12, 1.08, 0.88, 0.95};
-  static constexpr std::array<double, kLaneCount> kNoiseResScale {
-    0.90, 1.04, 1.12, 0.98, 1.00, 1.02, 1.12, 1.08};
-  static constexpr std::array<double, kLaneCount> kNoiseEnvScale {
-    0.88, 1.02, 1.18, 0.98, 1.00, 1.05, 1.18, 1.12};
-  static constexpr std::array<double, kLaneCount> kSnapScale {
-    0.24, 1.0, 0.86, 0.55, 0.52, 0.62, 0.68, 0.75};
-  static constexpr std::array<double, kLaneCount> kOscCutoffScale {
-    0.62, 0.88, 1.70, 1.08, 1.06, 1.12, 1.18, 1.15};
-  static constexpr std::array<double, kLaneCount> kOscResScale {
-    1.08, 1.0, 0.82, 0.96, 0.98, 1.00, 1.08, 1.05};
-  static constexpr std::array<double, kLaneCount> kOscEnvScale {
-    1.24, 1.02, 0.58, 0.92, 0.90, 0.88, 0.78, 0.82};
-  static constexpr std::array<double, kLaneCount> kOscBalance {
-    1.0, 0.92, 0.76, 0.94, 0.92, 0.90, 0.82, 0.86};
-  // Keep enough travel for sound design, but narrow the most extreme tuning
-  // swings so small moves land on more usable drum fundamentals.
-  static constexpr std::array<double, kLaneCount> kPitchSemitoneRange {
-    30.0, 24.0, 18.0, 28.0, 26.0, 22.0, 14.0, 16.0};
-  static constexpr std::array<bool, kLaneCount> kLaneIsLowRegister {
-    true, true, false, true, true, false, false, false};
-
-  const double oscFilterCutoffNorm = getParam (kParamOscFilterCutoff);
-  const double oscFilterResNorm = getParam (kParamOscFilterResonance);
-  const double oscFilterEnvNorm = getParam (kParamOscFilterEnv);
-  const double globalOscCutoffHz = 90.0 + (std::pow (oscFilterCutoffNorm, 1.80) * 15000.0);
-  const double globalOscResonance = 0.04 + (oscFilterResNorm * 0.88);
-  const double globalOscEnv = 0.10 + (oscFilterEnvNorm * 2.1);
+  // Only lanes with a changed input parameter since the last call are rebuilt.
+  if (dirtyLaneFrames_ == 0)
+    return;
 
-  for (int32 lane = 0; lane < kLaneCount; ++lane)
-  {
-    LaneFrame frame {};
-    frame.character = kLaneCharacters[lane];
-
-    const double tune = getMorphedParam (laneParamID (lane, kLaneTune));
-    const double semitoneRange = kPitchSemitoneRange[lane];
-    const double semitones = (tune * 2.0 - 1.0) * semitoneRange;
-    frame.frequencyHz = kBaseFrequencies[lane] * std::pow (2.0, semitones / 12.0);
-    frame.frequencyHz = std::clamp (frame.frequencyHz, 8.0, 20000.0);
-
-    const double decay = getMorphedParam (laneParamID (lane, kLaneDecay));
-    frame.decaySeconds = 0.02 + (decay * decay * 1.95);
-    const double level = getMorphedParam (laneParamID (lane, kLaneLevel));
-    frame.outputLevel = std::pow (level, 1.05);
-    frame.oscLevel = std::clamp ((0.40 + (std::pow (level, 0.80) * 1.25)) * kOscBalance[lane], 0.0, 2.0);
-    const double oscMix = getMorphedParam (laneOscMixParamID (lane));
-    frame.oscLevel *= oscMix;
-
-    const double foldRaw = getMorphedParam (laneParamID (lane, kLaneFold));
-    const double fmRaw = getMorphedParam (laneParamID (lane, kLaneFm));
-    const double foldMin = kLaneIsLowRegister[lane] ? 0.0 : 0.18;
-    const double foldMax = kLaneIsLowRegister[lane] ? 0.42 : 0.82;
-    const double fmMin = kLaneIsLowRegister[lane] ? 0.0 : 0.15;
-    const double fmMax = kLaneIsLowRegister[lane] ? 0.38 : 0.78;
-    frame.foldAmount = responseRange (foldRaw, foldMin, foldMax, 1.6);
-    frame.fmAmount = responseRange (fmRaw, fmMin, fmMax, 1.7);
-    frame.bodyFilterCutoffHz = std::clamp (globalOscCutoffHz * kOscCutoffScale[lane], 80.0, 18000.0);
-    frame.bodyFilterResonance =
-      std::clamp ((globalOscResonance + (frame.foldAmount * 0.12)) * kOscResScale[lane], 0.0, 0.98);
-    frame.bodyFilterEnvAmount = std::clamp (globalOscEnv * kOscEnvScale[lane], 0.0, 2.5);
-
-    const double noiseRaw = getMorphedParam (laneParamID (lane, kLaneNoise));
-    const double noiseMin = kLaneIsLowRegister[lane] ? 0.0 : 0.12;
-    const double noiseMax = kLaneIsLowRegister[lane] ? 0.40 : 0.80;
-    const double noise = responseRange (noiseRaw, noiseMin, noiseMax, 1.55);
-    frame.noiseAmount = std::clamp (std::pow (noise, 1.10) * 1.10, 0.0, 2.5);
-    frame.noiseLevel = std::clamp (std::pow (noise, 1.18) * kNoiseLevelScale[lane], 0.0, 2.5);
-    frame.pitchEnvAmount = std::clamp (getMorphedParam (laneExtraParamID (lane, kLanePitchEnvAmount)) *
-                                         kPitchEnvScale[lane],
-                                        0.0, 1.0);
-    const double pitchDecay = getMorphedParam (laneExtraParamID (lane, kLanePitchEnvDecay));
-    frame.pitchEnvDecaySeconds = 0.006 + (pitchDecay * pitchDecay * 0.55);
-    frame.transientAmount = std::clamp (std::pow (getMorphedParam (laneExtraParamID (lane, kLaneTransientAttack)), 1.10) *
-                                          kTransientAttackScale[lane],
-                                        0.0, 1.0);
-    const double transientDecay = getMorphedParam (laneMacroParamID (lane, kLaneTransientDecay));
-    frame.transientDecaySeconds =
-      std::clamp ((0.003 + (transientDecay * transientDecay * 0.46)) * kTransientDecayScale[lane], 0.0015, 0.5);
-    const double transientLevel = getMorphedParam (laneMacroParamID (lane, kLaneTransientMix));
-    // No minimum floor: at 0% the transient path is fully silent (was 0.18 bleed-through).
-    frame.transientLevel =
-      std::clamp (std::pow (transientLevel, 1.12) * 1.55 * kTransientLevelScale[lane], 0.0, 2.5);
-    frame.transientMix = std::clamp (transientLevel * 1.12, 0.0, 1.4);
-    const double noiseTone = getMorphedParam (laneExtraParamID (lane, kLaneNoiseTone));
-    frame.noiseTone = (noiseTone * 2.0) - 1.0;
-    frame.noiseFilterCutoffHz = 220.0 + (std::pow (noiseTone, 1.40) * 16000.0);
-    const double noiseDecay = getMorphedParam (laneExtraParamID (lane, kLaneNoiseDecay));
-    frame.noiseDecaySeconds = (0.008 + (noiseDecay * noiseDecay * 1.3));
-    frame.noiseResonance =
-      std::clamp ((0.05 + (getMorphedParam (laneMacroParamID (lane, kLaneNoiseResonance)) * 0.90)) * kNoiseResScale[lane],
-                  0.0, 0.98);
-    frame.noiseEnvAmount =
-      std::clamp ((0.18 + (getMorphedParam (laneMacroParamID (lane, kLaneNoiseEnvAmount)) * 1.25)) * kNoiseEnvScale[lane],
-                  0.0, 1.5);
-    frame.snapAmount = std::clamp (getMorphedParam (laneExtraParamID (lane, kLaneSnap)) * kSnapScale[lane], 0.0, 1.0);
-
-    const double driveRaw = getMorphedParam (laneParamID (lane, kLaneDrive));
-    const double driveMin = kLaneIsLowRegister[lane] ? 0.0 : 0.12;
-    const double driveMax = kLaneIsLowRegister[lane] ? 0.36 : 0.70;
-    frame.driveAmount = responseRange (driveRaw, driveMin, driveMax, 1.75);
-    frame.level = frame.outputLevel;
-    frame.pan = (getMorphedParam (laneParamID (lane, kLanePan)) * 2.0) - 1.0;
-
-    frame.oscFilterCutoff = getMorphedParam (laneFilterParamID (lane, kLaneOscFilterCutoff));
-    frame.oscFilterResonance = std::clamp (getMorphedParam (laneFilterParamID (lane, kLaneOscFilterRes)), 0.0, 1.0);
-    frame.oscFilterEnvAmount = getMorphedParam (laneFilterParamID (lane, kLaneOscFilterEnv));
-    frame.transFilterCutoff = getMorphedParam (laneFilterParamID (lane, kLaneTransFilterCutoff));
-    frame.transFilterResonance = std::clamp (getMorphedParam (laneFilterParamID (lane, kLaneTransFilterRes)), 0.0, 1.0);
-    frame.transFilterEnvAmount = getMorphedParam (laneFilterParamID (lane, kLaneTransFilterEnv));
-
-    laneFrames_[lane] = frame;
-  }
+  morphParameters (params_, dirtyLaneFrames_, morphedParams_);
+  buildLaneFramesFromMorphed (morphedParams_, dirtyLaneFrames_, laneFrames_);
+  dirtyLaneFrames_ = 0;
+  laneMixDirty_ = true;
 }
 
 void WestCoastProcessor::pushParamChange (Vst::IParameterChanges* outputChanges, Vst::ParamID id,
@@ -1049,30 +837,30 @@ void WestCoastProcessor::pushParamChange (Vst::IParameterChanges* outputChanges,
 
 double WestCoastProcessor::getParam (Vst::ParamID id) const
 {
-  if (id >= static_cast<Vst::ParamID> (kParameterStateSize))
+  const int32 index = denseParamIndex (id);
+  if (index < 0)
     return 0.0;
-  return params_[id];
-}
-
-double WestCoastProcessor::getMorphedParam (Vst::ParamID id) const
-{
-  double base = getParam (id);
-  if (id >= kLaneParamBase && id <= kLaneCoreMaxParamId)
-  {
-    const int32 offset = laneOffsetFromParamID (id);
-    if (offset == kLaneDrive || offset == kLaneLevel || offset == kLanePan)
-      return base;
-  }
-  const double morphSlider = getParam (kParamRandomizeAmount);
-  const double offset = (morphSlider - 0.5);
-  return clamp01 (base + offset);
+  return params_[static_cast<size_t> (index)];
 }
 
 void WestCoastProcessor::setParam (Vst::ParamID id, double normalizedValue)
 {
-  if (id >= static_cast<Vst::ParamID> (kParameterStateSize))
+  const int32 index = denseParamIndex (id);
+  if (index < 0)
+    return;
+  const double value = clamp01 (normalizedValue);
+  double& slot = params_[static_cast<size_t> (index)];
+  if (slot == value)
     return;
-  params_[id] = clamp01 (normalizedValue);
+  slot = value;
+  savedStateDirty_ = true;
+  dirtyLaneFrames_ |= laneFrameDependencyMask (id);
+  if ((id >= kLaneMuteParamBase && id <= kLaneMuteMaxParamId) || id == kParamKitMorph || id == kParamKitMorphTarget)
+    laneMixDirty_ = true;
+  if (id == kParamKitMorph || id == kParamKitMorphTarget)
+    kitMorphMoved_ = true;
+  if (isLaneOversamplingParamID (id))
+    oversamplingDirty_ = true;
 }
 
 } // namespace Steinberg::WestCoastDrumSynth
@@ -1,13 +1,21 @@
 #pragma once
 
 #include "ParameterIds.h"
-#include "engine/DrumVoice.h"
+#include "engine/DoubleBufferHandoff.h"
+#include "engine/DrumVoiceBank.h"
+#include "engine/EventQueue.h"
+#include "engine/KitMorph.h"
+#include "engine/LaneFrameBuilder.h"
+#include "engine/LaneMixState.h"
+#include "engine/ParameterRandomizer.h"
 #include "engine/StepSequencer.h"
+#include "presets/CompiledPresets.h"
 
 #include "public.sdk/source/vst/vstaudioeffect.h"
 
 #include <array>
-#include <random>
+#include <atomic>
+#include <bitset>
 
 namespace Steinberg::WestCoastDrumSynth {
 
@@ -27,29 +35,138 @@ public:
   tresult PLUGIN_API setupProcessing (Vst::ProcessSetup& setup) SMTG_OVERRIDE;
   tresult PLUGIN_API setActive (TBool state) SMTG_OVERRIDE;
   tresult PLUGIN_API process (Vst::ProcessData& data) SMTG_OVERRIDE;
+  uint32 PLUGIN_API getTailSamples () SMTG_OVERRIDE;
+  uint32 PLUGIN_API getLatencySamples () SMTG_OVERRIDE;
+  tresult PLUGIN_API notify (Vst::IMessage* message) SMTG_OVERRIDE;
 
 private:
+  // Engine image of one setState () call, built on the host's thread.
+  struct StateImage {
+    ParameterImage params {};
+    std::array<LaneFrame, kLaneCount> frames {};
+    int32 presetIndex {0};
+    RandomizerState randomizer {};
+    bool hasRandomizer {false};
+    // Counts setState () calls, so a snapshot can tell which one it already reflects.
+    uint32 generation {0};
+  };
+
+  // What getState () saves: the parameters, preset and randomizer as process () last published
+  // them, or as the latest setState () left them.
+  struct SavedState {
+    ParameterImage params {};
+    int32 presetIndex {0};
+    RandomizerState randomizer {};
+    // StateImage::generation of the last setState () applied before the snapshot was taken.
+    uint32 stateGeneration {0};
+  };
+
   void resetEngine ();
-  void loadPresetByIndex (int32 presetIndex, Vst::IParameterChanges* outputChanges);
-  void processParameterChanges (Vst::IParameterChanges* changes, Vst::IParameterChanges* outputChanges);
+  // Swaps in the image of the last setState (), if process () has not picked it up yet.
+  void applyPendingState ();
+  // Hands params_, loadedPreset_ and randomizer_ to getState () when they changed since the last
+  // call; called at the end of process ().
+  void publishSavedState ();
+  // Switches to a precompiled factory preset; its parameter values reach the controller over the
+  // following blocks through echoParameters ().
+  void loadPresetByIndex (int32 presetIndex);
+  // Applies a Randomize press to every randomized parameter; the new values are echoed like a
+  // preset switch.
+  void randomizeParameters ();
+  // Marks dense slots whose values the controller has to be told about.
+  void queueParameterEcho (const int16* slots, int32 numSlots);
+  // Sends up to kParamEchoChangesPerBlock of the queued parameter values to the host.
+  void echoParameters (Vst::IParameterChanges* outputChanges);
+  // Applies parameter changes at block start and queues automation points inside the block in
+  // parameterQueue_ for process () to apply at their sample offsets. When that runs out of room,
+  // a parameter's final value goes to parameterOverflow_ instead, applied after the block.
+  void processParameterChanges (Vst::IParameterChanges* changes, Vst::IParameterChanges* outputChanges,
+                                int32 numSamples);
+  // Applies every queued automation point at once (blocks that are not rendered), then the
+  // overflowed final values.
+  void flushParameterEvents ();
+  // The voice bank that renders Sample: voices_ or voicesFloat_.
+  template <typename Sample>
+  DrumVoiceBankT<Sample>& voiceBank ();
+  // Re-blends kitFrames_ and rebuilds laneMix_ from them when laneMixDirty_ is set; a moved
+  // morph also retunes the voices already sounding in the bank that renders.
+  void refreshLaneMix ();
+  // Passes the lane oversampling factors to both voice banks when oversamplingDirty_ is set.
+  void refreshOversampling ();
   void updateLaneFramesFromParameters ();
   void pushParamChange (Vst::IParameterChanges* outputChanges, Vst::ParamID id, double normalizedValue) const;
   double getParam (Vst::ParamID id) const;
-  double getMorphedParam (Vst::ParamID id) const;
   void setParam (Vst::ParamID id, double normalizedValue);
 
-  std::array<double, kParameterStateSize> params_ {};
+  // Indexed by denseParamIndex (); each lane's parameters share one cache-line aligned block.
+  alignas (64) ParameterImage params_ {};
+  // params_ after the morph slider; only the globals and the blocks of lanes rebuilt by the last
+  // updateLaneFramesFromParameters () calls are current.
+  alignas (64) ParameterImage morphedParams_ {};
   std::array<LaneFrame, kLaneCount> laneFrames_ {};
-  std::array<DrumVoice, kLaneCount> voices_ {};
+  // What voices are triggered with and the mix is built from: laneFrames_ (kit A) blended towards
+  // the compiled frames of the kit morph target (kit B). Re-blending skips the parameter mapping.
+  std::array<LaneFrame, kLaneCount> kitFrames_ {};
+  LaneFrameBank kitBankA_ {};
+  LaneFrameBank kitBankB_ {};
+  // Factory preset kitBankB_ holds, -1 before the first morph.
+  int32 kitBankBPreset_ {-1};
+  // Voices render in the host's sample type, picked in setupProcessing (): voices_ for 64-bit
+  // processing, voicesFloat_ (float apart from its phases and envelope decays) for 32-bit.
+  DrumVoiceBank voices_ {};
+  DrumVoiceBankT<float> voicesFloat_ {};
+  bool floatEngine_ {false};
+  LaneMixState laneMix_ {};
+  // Set whenever lane frames or mutes may have changed; process () rebuilds laneMix_ from it.
+  bool laneMixDirty_ {true};
+  // Set when the kit morph position or target changed; refreshLaneMix () then retunes the
+  // sounding voices to the new blend as well.
+  bool kitMorphMoved_ {false};
+  // Set whenever a lane oversampling factor may have changed; applied at the next block start.
+  bool oversamplingDirty_ {true};
+  // Lanes whose frame inputs changed since the last updateLaneFramesFromParameters ().
+  uint32 dirtyLaneFrames_ {kAllLanesMask};
   StepSequencer sequencer_ {};
+  // setState () is the producer, process () (or setState () itself while inactive) the consumer.
+  DoubleBufferHandoff<StateImage> stateHandoff_ {};
+  // The reverse direction: process () produces, getState () consumes into savedState_, which only
+  // the host's thread touches. stateGeneration_ counts setState () calls on that thread,
+  // appliedStateGeneration_ the one process () applied last.
+  TripleBufferHandoff<SavedState> savedStateHandoff_ {};
+  SavedState savedState_ {};
+  uint32 stateGeneration_ {0};
+  uint32 appliedStateGeneration_ {0};
+  // Set whenever params_, loadedPreset_ or randomizer_ may have changed.
+  bool savedStateDirty_ {true};
+  ParameterImage defaultParams_ {};
+  std::atomic<bool> active_ {false};
+  TriggerEventQueue triggerQueue_ {};
+  ParameterEventQueue parameterQueue_ {};
+  ParameterOverflowQueue parameterOverflow_ {};
 
   std::array<double, kLaneCount> laneLedState_ {};
   std::array<int32, kLaneCount> laneLedFlashSamples_ {};
   int32 ledFlashDurationSamples_ {2205};
+  // Refreshed at the end of every process () call; read by the host from any thread.
+  std::atomic<uint32> tailSamples_ {Vst::kNoTail};
+  // Tail of a hit on any lane of kitFrames_, recomputed at the block end after kitFrames_ or the
+  // latency changed.
+  uint32 kitTailSamples_ {0};
+  bool kitTailDirty_ {true};
+  // Lane oversampling factors as the host's thread last learned them, from the controller's
+  // kOversamplingMessageId or setState (). They lead the factors process () applies by up to a
+  // block, so the latency they give is current when the controller has the host re-read it.
+  std::array<int32, kLaneCount> hostOversampling_ {1, 1, 1, 1, 1, 1, 1, 1};
+  // bankOversamplingLatency (hostOversampling_); read by the host from any thread.
+  std::atomic<uint32> latencySamples_ {0};
+
+  static constexpr int32 kParamEchoChangesPerBlock = 32;
 
   int32 loadedPreset_ {0};
   bool presetPending_ {true};
-  std::mt19937 rng_ {std::random_device {}()};
+  // Dense slots changed by a preset switch or Randomize whose values are not echoed yet.
+  std::bitset<kDenseParameterCount> echoPending_ {};
+  RandomizerState randomizer_ {};
 };
 
 } // namespace Steinberg::WestCoastDrumSynth
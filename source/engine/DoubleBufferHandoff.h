@@ -0,0 +1,95 @@
+#pragma once
+
+#include "ParameterIds.h"
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+// Hands whole values from one producer thread to one consumer thread through Slots slots and one
+// atomic word. The producer fills a slot that is neither published nor being read, then
+// publishes it, replacing a publication the consumer has not picked up yet. The consumer side
+// never blocks. With two slots the producer yields while the consumer is still reading the slot
+// it needs, which suits a host-thread producer; with three it never waits, so the audio thread
+// can be the producer.
+template <typename T, int32 Slots = 2>
+class DoubleBufferHandoff {
+  static_assert (Slots == 2 || Slots == 3);
+
+public:
+  // Producer: the slot to fill before publish ().
+  T& beginWrite ()
+  {
+    for (;;)
+    {
+      const uint32 state = state_.load (std::memory_order_acquire);
+      const int32 pending = pendingSlot (state);
+      const int32 reading = readingSlot (state);
+      for (int32 slot = 0; slot < Slots; ++slot)
+      {
+        if (slot != pending && slot != reading)
+        {
+          writeSlot_ = slot;
+          return slots_[slot];
+        }
+      }
+      std::this_thread::yield ();
+    }
+  }
+
+  // Producer: makes the slot returned by beginWrite () the one the next consume () applies.
+  void publish ()
+  {
+    uint32 state = state_.load (std::memory_order_relaxed);
+    uint32 next = 0;
+    do
+    {
+      next = (state & kReadingMask) | static_cast<uint32> (writeSlot_ + 1);
+    } while (!state_.compare_exchange_weak (state, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+  }
+
+  // Consumer: passes the latest publication, if any arrived since the last call, to apply.
+  template <typename Apply>
+  bool consume (Apply&& apply)
+  {
+    uint32 state = state_.load (std::memory_order_acquire);
+    uint32 next = 0;
+    do
+    {
+      if (pendingSlot (state) < 0)
+        return false;
+      next = static_cast<uint32> (pendingSlot (state) + 1) << kReadingShift;
+    } while (!state_.compare_exchange_weak (state, next, std::memory_order_acq_rel, std::memory_order_acquire));
+
+    apply (static_cast<const T&> (slots_[pendingSlot (state)]));
+    state_.fetch_and (~kReadingMask, std::memory_order_release);
+    return true;
+  }
+
+private:
+  // Low two bits: published slot + 1; next two bits: slot the consumer reads + 1; 0 for none.
+  static constexpr uint32 kPendingMask = 0x3u;
+  static constexpr uint32 kReadingShift = 2;
+  static constexpr uint32 kReadingMask = 0x3u << kReadingShift;
+
+  static int32 pendingSlot (uint32 state)
+  {
+    return static_cast<int32> (state & kPendingMask) - 1;
+  }
+
+  static int32 readingSlot (uint32 state)
+  {
+    return static_cast<int32> ((state & kReadingMask) >> kReadingShift) - 1;
+  }
+
+  std::array<T, Slots> slots_ {};
+  std::atomic<uint32> state_ {0};
+  int32 writeSlot_ {0};
+};
+
+template <typename T>
+using TripleBufferHandoff = DoubleBufferHandoff<T, 3>;
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -1,367 +0,0 @@
-#include "engine/DrumVoice.h"
-
-#include <algorithm>
-#include <array>
-#include <cmath>
-#include <cstddef>
-
-namespace Steinberg::WestCoastDrumSynth {
-
-namespace {
-
-constexpr double kTwoPi = 6.28318530717958647692;
-constexpr double kPi = 3.14159265358979323846;
-
-inline double clamp01 (double x)
-{
-  return std::clamp (x, 0.0, 1.0);
-}
-
-inline size_t characterIndex (LaneCharacter character)
-{
-  return static_cast<size_t> (character);
-}
-
-inline double softClip (double x)
-{
-  constexpr double kSoftClipDrive = 1.42;
-  return std::tanh (x * kSoftClipDrive) / std::tanh (kSoftClipDrive);
-}
-
-// Indexed by LaneCharacter: Kick, Snare, Hat, PercA, PercB, RimShot, Clap
-constexpr std::array<double, 7> kPitchSemitoneSpan {66.0, 20.0, 8.0, 36.0, 32.0, 18.0, 14.0};
-constexpr std::array<double, 7> kTransientBaseHz {3200.0, 2500.0, 7000.0, 2200.0, 4500.0, 3500.0, 2200.0};
-constexpr std::array<double, 7> kNoiseBlendGain {0.85, 1.25, 1.45, 1.10, 1.15, 1.30, 1.45};
-constexpr std::array<double, 7> kBodyGain {1.05, 0.84, 0.42, 1.02, 0.96, 0.92, 0.88};
-constexpr std::array<double, 7> kFmScale {1.0, 0.85, 0.40, 0.92, 0.88, 0.65, 0.45};
-constexpr std::array<double, 7> kNoiseTransientBlend {0.62, 0.68, 0.38, 0.65, 0.58, 0.72, 0.55};
-constexpr std::array<double, 7> kTransientGainBoost {1.65, 1.0, 1.0, 1.45, 1.35, 1.0, 1.0};
-
-inline double cutoffFromNormalized (double normalized, double minHz, double maxHz)
-{
-  return minHz * std::pow (maxHz / minHz, normalized);
-}
-
-} // namespace
-
-void DrumVoice::setSampleRate (double sampleRate)
-{
-  sampleRate_ = std::max (sampleRate, 1000.0);
-}
-
-void DrumVoice::trigger (const LaneFrame& frame)
-{
-  // Store previous output for anti-click crossfade if voice was active
-  if (active_ && ampEnv_ > 0.001)
-  {
-    antiClickLength_ = std::max (32, static_cast<int32_t> (sampleRate_ * 0.0008));
-    antiClickSamples_ = antiClickLength_;
-  }
-  else
-  {
-    antiClickSamples_ = 0;
-    antiClickLength_ = 0;
-    antiClickPrevSample_ = 0.0;
-  }
-
-  frame_ = frame;
-  frame_.frequencyHz = std::clamp (frame_.frequencyHz, 8.0, 18000.0);
-  frame_.oscLevel = std::clamp (frame_.oscLevel, 0.0, 2.0);
-  frame_.bodyFilterCutoffHz = std::clamp (frame_.bodyFilterCutoffHz, 80.0, 18000.0);
-  frame_.bodyFilterResonance = std::clamp (frame_.bodyFilterResonance, 0.0, 0.98);
-  frame_.bodyFilterEnvAmount = std::clamp (frame_.bodyFilterEnvAmount, 0.0, 2.5);
-  frame_.outputLevel = std::clamp (frame_.outputLevel, 0.0, 1.5);
-  frame_.noiseLevel = std::clamp (frame_.noiseLevel, 0.0, 2.5);
-  frame_.pitchEnvAmount = clamp01 (frame_.pitchEnvAmount);
-  frame_.noiseAmount = std::clamp (frame_.noiseAmount, 0.0, 2.5);
-  frame_.noiseFilterCutoffHz = std::clamp (frame_.noiseFilterCutoffHz, 120.0, 18000.0);
-  frame_.transientAmount = clamp01 (frame_.transientAmount);
-  frame_.transientLevel = std::clamp (frame_.transientLevel, 0.0, 2.5);
-  frame_.transientMix = std::clamp (frame_.transientMix, 0.0, 1.4);
-  frame_.snapAmount = clamp01 (frame_.snapAmount);
-  frame_.noiseTone = std::clamp (frame_.noiseTone, -1.0, 1.0);
-  frame_.noiseResonance = std::clamp (frame_.noiseResonance, 0.0, 0.98);
-  frame_.noiseEnvAmount = std::clamp (frame_.noiseEnvAmount, 0.0, 1.5);
-  frame_.level = std::clamp (frame_.level, 0.0, 1.5);
-  frame_.foldAmount = clamp01 (frame_.foldAmount);
-  frame_.fmAmount = clamp01 (frame_.fmAmount);
-  frame_.driveAmount = clamp01 (frame_.driveAmount);
-  frame_.decaySeconds = std::clamp (frame_.decaySeconds, 0.01, 2.5);
-  frame_.pitchEnvDecaySeconds = std::clamp (frame_.pitchEnvDecaySeconds, 0.004, 0.8);
-  frame_.noiseDecaySeconds = std::clamp (frame_.noiseDecaySeconds, 0.004, 1.8);
-  frame_.transientDecaySeconds = std::clamp (frame_.transientDecaySeconds, 0.0015, 0.5);
-  frame_.oscFilterCutoff = clamp01 (frame_.oscFilterCutoff);
-  frame_.oscFilterResonance = std::clamp (frame_.oscFilterResonance, 0.0, 0.96);
-  frame_.oscFilterEnvAmount = clamp01 (frame_.oscFilterEnvAmount);
-  frame_.transFilterCutoff = clamp01 (frame_.transFilterCutoff);
-  frame_.transFilterResonance = std::clamp (frame_.transFilterResonance, 0.0, 0.96);
-  frame_.transFilterEnvAmount = clamp01 (frame_.transFilterEnvAmount);
-
-  const double ampTau = frame_.decaySeconds;
-  const double toneTau = std::max (0.01, frame_.decaySeconds * 0.28);
-  const double pitchTau = frame_.pitchEnvDecaySeconds;
-  const double noiseTau = frame_.noiseDecaySeconds;
-  const double transientTau =
-    std::clamp (frame_.transientDecaySeconds * (1.02 - (0.38 * frame_.snapAmount)), 0.0012, 0.5);
-  ampDecayCoef_ = std::exp (-1.0 / (ampTau * sampleRate_));
-  toneDecayCoef_ = std::exp (-1.0 / (toneTau * sampleRate_));
-  pitchDecayCoef_ = std::exp (-1.0 / (pitchTau * sampleRate_));
-  noiseDecayCoef_ = std::exp (-1.0 / (noiseTau * sampleRate_));
-  transientDecayCoef_ = std::exp (-1.0 / (transientTau * sampleRate_));
-  const double clickTauSec = std::clamp (0.00035 + (frame_.snapAmount * 0.00055), 0.0002, 0.002);
-  clickDecayCoef_ = std::exp (-1.0 / (clickTauSec * sampleRate_));
-  clickEnv_ = 1.0;
-
-  const double tone01 = clamp01 ((frame_.noiseTone + 1.0) * 0.5);
-  const double baseNoiseCutoff = frame_.noiseFilterCutoffHz * (0.40 + (tone01 * 0.70));
-  const double lowCutoffHz = std::clamp (baseNoiseCutoff * 0.95, 180.0, 14000.0);
-  const double highCutoffHz = std::clamp (baseNoiseCutoff * 0.50, 100.0, 9000.0);
-  noiseLpCoef_ = 1.0 - std::exp (-(kTwoPi * lowCutoffHz) / sampleRate_);
-  noiseHpCoef_ = 1.0 - std::exp (-(kTwoPi * highCutoffHz) / sampleRate_);
-  noiseLpCoef_ = std::clamp (noiseLpCoef_, 0.0, 1.0);
-  noiseHpCoef_ = std::clamp (noiseHpCoef_, 0.0, 1.0);
-
-  // Clear filter states on trigger to prevent stale resonance
-  oscFilterLowState_ = 0.0;
-  oscFilterBandState_ = 0.0;
-  transFilterLowState_ = 0.0;
-  transFilterBandState_ = 0.0;
-  noiseResLowState_ = 0.0;
-  noiseResBandState_ = 0.0;
-
-  carrierPhase_ = 0.0;
-  modPhase_ = 0.0;
-  transientPhase_ = 0.0;
-
-  ampEnv_ = 1.0;
-  toneEnv_ = 1.0;
-  pitchEnv_ = 1.0;
-  noiseEnv_ = 1.0;
-  transientEnv_ = 1.0;
-  active_ = true;
-}
-
-double DrumVoice::process ()
-{
-  if (!active_)
-    return 0.0;
-
-  const size_t character = std::min (characterIndex (frame_.character), size_t {6});
-
-  // --- OSCILLATOR PATH ---
-  const double pitchSemitoneSweep = frame_.pitchEnvAmount * pitchEnv_ * kPitchSemitoneSpan[character];
-  const double pitchRatio = std::pow (2.0, pitchSemitoneSweep / 12.0);
-
-  const double modFrequency =
-    frame_.frequencyHz * pitchRatio * (1.0 + (frame_.fmAmount * (5.5 * kFmScale[character])));
-  const double carrierFrequency = frame_.frequencyHz * pitchRatio * (1.0 + (toneEnv_ * 0.07));
-
-  modPhase_ += (kTwoPi * modFrequency) / sampleRate_;
-  carrierPhase_ += (kTwoPi * carrierFrequency) / sampleRate_;
-  const double transFreqSweep = 0.7 + (frame_.transientAmount * 1.5);
-  transientPhase_ += (kTwoPi * kTransientBaseHz[character] * transFreqSweep) / sampleRate_;
-  modPhase_ = wrapPhase (modPhase_);
-  carrierPhase_ = wrapPhase (carrierPhase_);
-  transientPhase_ = wrapPhase (transientPhase_);
-
-  // Thru-zero FM: modulation depth allows phase reversal (negative instantaneous freq)
-  const double fmDepth = frame_.fmAmount * ((12.0 * toneEnv_ * kFmScale[character]) + 0.5);
-  const double modSignal = std::sin (modPhase_) * fmDepth;
-  double body = std::sin (carrierPhase_ + modSignal);
-
-  // Wavefolding: more dynamic range (1 + amount*16), 5 folds for richer harmonics
-  const double dynamicFold = frame_.foldAmount * (1.2 + (1.2 * toneEnv_));
-  body = wavefold (body, dynamicFold);
-
-  // Per-lane osc filter: 0 = nearly closed, 1 = full openness (no mid-neutral 0.4 floor)
-  const double oscClosedHz = 72.0;
-  const double oscOpenHz = std::max (140.0, frame_.bodyFilterCutoffHz);
-  const double oscNorm = clamp01 (frame_.oscFilterCutoff);
-  const double oscBaseCutoff = oscClosedHz + (oscOpenHz - oscClosedHz) * std::pow (oscNorm, 0.82);
-  const double oscEnvMod =
-    oscBaseCutoff * frame_.bodyFilterEnvAmount * frame_.oscFilterEnvAmount * toneEnv_ * 4.5;
-  const double oscCutoffHz = std::clamp (oscBaseCutoff + oscEnvMod, 20.0, sampleRate_ * 0.47);
-  const double oscResScaled =
-    std::min (0.98, (frame_.bodyFilterResonance * 0.5 + frame_.oscFilterResonance * 0.5) * 1.35);
-  body = processStateVariableLowpass (body, oscCutoffHz, oscResScaled,
-                                      oscFilterLowState_, oscFilterBandState_);
-  const double oscGate = ampEnv_ * (0.38 + (0.72 * toneEnv_));
-  const double oscOut = body * frame_.oscLevel * oscGate * kBodyGain[character] * 1.41;
-
-  // --- TRANSIENT PATH ---
-  const double transientOsc = std::sin (transientPhase_);
-  const double transientNoise = randomBipolar ();
-  const double transientBlend =
-    std::clamp ((frame_.transientMix * 0.65) + (frame_.snapAmount * kNoiseTransientBlend[character]), 0.0, 1.0);
-  const double transientCore = (transientOsc * (1.0 - transientBlend)) + (transientNoise * transientBlend);
-
-  const double transBaseCutoff = cutoffFromNormalized (frame_.transFilterCutoff, 95.0, 20000.0);
-  const double transEnvMod = transBaseCutoff * frame_.transFilterEnvAmount * transientEnv_ * 4.0;
-  const double transCutoffHz = std::clamp (transBaseCutoff + transEnvMod, 70.0, sampleRate_ * 0.43);
-  const double transResScaled = std::min (0.96, frame_.transFilterResonance * 1.35);
-  const double filteredTransient = processStateVariableLowpass (transientCore, transCutoffHz,
-                                                                transResScaled,
-                                                                transFilterLowState_, transFilterBandState_);
-
-  const double transientGain =
-    (0.5 + (frame_.transientAmount * 1.5)) * frame_.transientLevel * kTransientGainBoost[character];
-  const double clickAmt =
-    (0.42 + (frame_.snapAmount * 0.55)) * (0.35 + (frame_.transientAmount * 1.15)) * transientEnv_;
-  const double clickOut = transientCore * clickEnv_ * clickAmt * transientGain;
-  clickEnv_ *= clickDecayCoef_;
-  const double transOut = (filteredTransient * transientEnv_ * transientGain) + clickOut;
-
-  // --- NOISE PATH ---
-  const double rawNoise = randomBipolar ();
-  noiseLowState_ += noiseLpCoef_ * (rawNoise - noiseLowState_);
-  noiseHighState_ += noiseHpCoef_ * (rawNoise - noiseHighState_);
-  const double highNoise = rawNoise - noiseHighState_;
-  const double toneBlend = clamp01 ((frame_.noiseTone + 1.0) * 0.5);
-  const double shapedNoise = ((1.0 - toneBlend) * noiseLowState_) + (toneBlend * highNoise);
-
-  const double snapExponent = std::clamp (0.85 - (frame_.snapAmount * 0.55), 0.25, 1.0);
-  const double snappyEnv = std::pow (std::max (noiseEnv_, 0.0), snapExponent);
-  const double noiseContour = ((1.0 - frame_.snapAmount) * noiseEnv_) + (frame_.snapAmount * snappyEnv);
-  const double noiseCutoffBase = frame_.noiseFilterCutoffHz * (0.45 + (toneBlend * 0.90));
-  const double noiseCutoffEnv = std::clamp (noiseCutoffBase * (0.60 + (noiseContour * (1.1 + (frame_.noiseEnvAmount * 2.4)))),
-                                            180.0, 19000.0);
-  const double noiseResonance = std::clamp (frame_.noiseResonance + (frame_.snapAmount * 0.16), 0.0, 0.98);
-  const double resonantNoise = processStateVariableLowpass (shapedNoise, noiseCutoffEnv, noiseResonance,
-                                                            noiseResLowState_, noiseResBandState_);
-  const double noiseOut =
-    resonantNoise * frame_.noiseAmount * frame_.noiseLevel * noiseContour * kNoiseBlendGain[character];
-
-  // --- SUMMING (per-voice, no dynamic normalization) ---
-  const double drive = 1.0 + (frame_.driveAmount * 6.0);
-  const double rawMix = oscOut + noiseOut + transOut;
-  double sample = softClip (rawMix * drive) * frame_.outputLevel;
-
-  // Anti-click crossfade: blend previous tail with new attack
-  if (antiClickSamples_ > 0 && antiClickLength_ > 0)
-  {
-    const double fade = static_cast<double> (antiClickSamples_) / static_cast<double> (antiClickLength_);
-    sample = sample * (1.0 - fade) + antiClickPrevSample_ * fade;
-    antiClickPrevSample_ *= 0.92;
-    --antiClickSamples_;
-  }
-
-  // DC blocker (leaky integrator, ~5 Hz cutoff)
-  constexpr double kDcCoef = 0.9995;
-  const double dcIn = sample;
-  dcY_ = dcIn - dcX_ + kDcCoef * dcY_;
-  dcX_ = dcIn;
-  sample = dcY_;
-
-  // --- ENVELOPE DECAY ---
-  ampEnv_ *= ampDecayCoef_;
-  toneEnv_ *= toneDecayCoef_;
-  pitchEnv_ *= pitchDecayCoef_;
-  noiseEnv_ *= noiseDecayCoef_;
-  transientEnv_ *= transientDecayCoef_;
-
-  if (ampEnv_ < 0.00008 && noiseEnv_ < 0.00008 && transientEnv_ < 0.00008 && clickEnv_ < 0.00002)
-  {
-    active_ = false;
-    ampEnv_ = 0.0;
-    toneEnv_ = 0.0;
-    pitchEnv_ = 0.0;
-    noiseEnv_ = 0.0;
-    transientEnv_ = 0.0;
-    clickEnv_ = 0.0;
-  }
-
-  return sample;
-}
-
-void DrumVoice::reset ()
-{
-  carrierPhase_ = 0.0;
-  modPhase_ = 0.0;
-  transientPhase_ = 0.0;
-  ampEnv_ = 0.0;
-  toneEnv_ = 0.0;
-  pitchEnv_ = 0.0;
-  noiseEnv_ = 0.0;
-  transientEnv_ = 0.0;
-  clickEnv_ = 0.0;
-  noiseLowState_ = 0.0;
-  noiseHighState_ = 0.0;
-  noiseResLowState_ = 0.0;
-  noiseResBandState_ = 0.0;
-  bodyLowState_ = 0.0;
-  bodyBandState_ = 0.0;
-  oscFilterLowState_ = 0.0;
-  oscFilterBandState_ = 0.0;
-  transFilterLowState_ = 0.0;
-  transFilterBandState_ = 0.0;
-  antiClickSamples_ = 0;
-  antiClickLength_ = 0;
-  antiClickPrevSample_ = 0.0;
-  dcX_ = 0.0;
-  dcY_ = 0.0;
-  active_ = false;
-}
-
-bool DrumVoice::isActive () const
-{
-  return active_;
-}
-
-double DrumVoice::wavefold (double x, double amount)
-{
-  const double gain = 1.0 + (amount * 16.0);
-  x *= gain;
-
-  for (int i = 0; i < 5; ++i)
-  {
-    if (x > 1.0)
-      x = 2.0 - x;
-    else if (x < -1.0)
-      x = -2.0 - x;
-  }
-  return x;
-}
-
-double DrumVoice::processStateVariableLowpass (double input, double cutoffHz, double resonance, double& lowState,
-                                               double& bandState)
-{
-  const double maxCutoff = sampleRate_ * 0.43;
-  const double clippedCutoff = std::clamp (cutoffHz, 20.0, maxCutoff);
-  const double f = std::clamp (2.0 * std::sin (kPi * clippedCutoff / sampleRate_), 0.0, 0.95);
-  const double q = std::clamp (resonance, 0.0, 0.96);
-  const double damping = 1.0 - q;
-
-  // Two-pass (2x oversampled) for stability at high cutoffs
-  for (int pass = 0; pass < 2; ++pass)
-  {
-    const double high = input - lowState - (damping * bandState);
-    bandState += 0.5 * f * high;
-    lowState += 0.5 * f * bandState;
-  }
-
-  // Clamp filter states to prevent runaway
-  bandState = std::clamp (bandState, -8.0, 8.0);
-  lowState = std::clamp (lowState, -8.0, 8.0);
-
-  return lowState;
-}
-
-double DrumVoice::randomBipolar ()
-{
-  noiseState_ ^= (noiseState_ << 13);
-  noiseState_ ^= (noiseState_ >> 17);
-  noiseState_ ^= (noiseState_ << 5);
-  const double unit = static_cast<double> (noiseState_ & 0x00FFFFFF) / static_cast<double> (0x00FFFFFF);
-  return (unit * 2.0) - 1.0;
-}
-
-double DrumVoice::wrapPhase (double phase)
-{
-  while (phase >= kTwoPi)
-    phase -= kTwoPi;
-  while (phase < 0.0)
-    phase += kTwoPi;
-  return phase;
-}
-
-} // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,931 @@
+#include "engine/DrumVoiceBank.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+using namespace VoiceDsp;
+
+namespace {
+
+inline uint32 laneBit (int32 lane)
+{
+  return 1u << static_cast<uint32> (lane);
+}
+
+// Samples an exponential envelope at level needs to fall below floor.
+inline double samplesToDecay (double level, double decayCoef, double floor)
+{
+  if (level < floor || decayCoef <= 0.0 || decayCoef >= 1.0)
+    return 0.0;
+  return std::log (floor / level) / std::log (decayCoef);
+}
+
+// Envelope levels of one lane; the defaults are those trigger () starts from.
+struct LaneEnvelopes {
+  double amp {1.0};
+  double noise {1.0};
+  double transient {1.0};
+  double click {1.0};
+};
+
+// Samples until a lane stops, at the earlier of two points: amp, noise and transient under
+// kVoiceEnvFloor with the click under kVoiceClickFloor, or every audible path dormant. The noise
+// path goes dormant on its contour, which stays below noiseEnv^snapExponent.
+template <typename Coefficients>
+double samplesUntilSilent (const Coefficients& c, size_t lane, uint32_t paths, const LaneEnvelopes& envelopes)
+{
+  const double amp = samplesToDecay (envelopes.amp, laneValue (c.ampDecayCoef, lane), kVoiceEnvFloor);
+  const double noiseDecayCoef = laneValue (c.noiseDecayCoef, lane);
+  const double noise = samplesToDecay (envelopes.noise, noiseDecayCoef, kVoiceEnvFloor);
+  const double transient =
+    samplesToDecay (envelopes.transient, laneValue (c.transientDecayCoef, lane), kVoiceEnvFloor);
+  const double contour = samplesToDecay (envelopes.noise, noiseDecayCoef,
+                                         std::pow (kVoiceEnvFloor, 1.0 / laneValue (c.snapExponent, lane)));
+
+  // The click only decays while the transient path renders; once frozen it never reaches its floor.
+  double click = samplesToDecay (envelopes.click, laneValue (c.clickDecayCoef, lane), kVoiceClickFloor);
+  if (click > 0.0 && ((paths & kTransientPath) == 0 || click > transient))
+    click = std::numeric_limits<double>::infinity ();
+
+  const double allBelowFloor = std::max ({amp, noise, transient, click});
+  double allDormant = 0.0;
+  if ((paths & kOscPath) != 0)
+    allDormant = std::max (allDormant, amp);
+  if ((paths & kTransientPath) != 0)
+    allDormant = std::max (allDormant, transient);
+  if ((paths & kNoisePath) != 0)
+    allDormant = std::max (allDormant, contour);
+  return std::min (allBelowFloor, allDormant);
+}
+
+} // namespace
+
+template <typename Sample>
+DrumVoiceBankT<Sample>::DrumVoiceBankT ()
+{
+  noiseState_.fill (0x9E3779B9U);
+  oversampling_.fill (1);
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::setSampleRate (double sampleRate)
+{
+  sampleRate_ = std::max (sampleRate, 1000.0);
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::setControlInterval (int32 samples)
+{
+  controlInterval_ = clampControlInterval (samples);
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    coefficients_.toneControlDecay[lane] = static_cast<Sample> (controlDecay (toneDecay_[lane], controlInterval_));
+    coefficients_.transientControlDecay[lane] =
+      static_cast<Sample> (controlDecay (transientDecay_[lane], controlInterval_));
+    coefficients_.noiseControlDecay[lane] = static_cast<Sample> (controlDecay (noiseDecay_[lane], controlInterval_));
+  }
+}
+
+template <typename Sample>
+int32 DrumVoiceBankT<Sample>::controlInterval () const
+{
+  return controlInterval_;
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::setCoefficientErrorTracking (bool enabled)
+{
+  trackCoefficientError_ = enabled;
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::setAntiAliasing (bool enabled)
+{
+  antiAliasing_ = enabled;
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::setOversampling (int32 lane, int32 factor)
+{
+  if (lane < 0 || lane >= kLaneCount)
+    return;
+  factor = factor >= kMaxOversampling ? kMaxOversampling : (factor >= 2 ? 2 : 1);
+  if (factor == oversampling_[lane])
+    return;
+
+  oversampling_[lane] = factor;
+  resetOversampling (lane);
+  latency_ = bankOversamplingLatency (oversampling_);
+}
+
+template <typename Sample>
+uint32 DrumVoiceBankT<Sample>::latencySamples () const
+{
+  return static_cast<uint32> (latency_);
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::loadCoefficients (int32 lane, const VoiceCoefficients& laneCoefficients)
+{
+  forEachCoefficient (coefficients_, laneCoefficients,
+                      [lane] (LaneArray<Sample>& dest, double value) { dest[lane] = static_cast<Sample> (value); });
+  ampDecay_[lane] = laneCoefficients.ampDecayCoef;
+  toneDecay_[lane] = laneCoefficients.toneDecayCoef;
+  pitchDecay_[lane] = laneCoefficients.pitchDecayCoef;
+  noiseDecay_[lane] = laneCoefficients.noiseDecayCoef;
+  transientDecay_[lane] = laneCoefficients.transientDecayCoef;
+  clickDecay_[lane] = laneCoefficients.clickDecayCoef;
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::endGainRamp (int32 lane)
+{
+  forEachGainCoefficient (coefficients_, gainTarget_, [lane] (auto& gain, const auto& target) {
+    gain[lane] = target[lane];
+  });
+  forEachGainCoefficient (gainStep_, gainTarget_, [lane] (auto& step, const auto&) { step[lane] = Sample (0); });
+  gainRamp_[lane] = 0;
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::resetOversampling (int32 lane)
+{
+  foldOversampler_[lane].reset ();
+  clipOversampler_[lane].reset ();
+  pathDelay_[lane].reset ();
+  oscCoefDelay_[lane].reset ();
+  oscGateDelay_[lane].reset ();
+  alignDelay_[lane].reset ();
+}
+
+template <typename Sample>
+const CoefficientErrorStats& DrumVoiceBankT<Sample>::coefficientErrorStats () const
+{
+  return coefficientError_;
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::resetCoefficientErrorStats ()
+{
+  coefficientError_ = {};
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::trigger (int32 lane, const LaneFrame& frame)
+{
+  if (lane < 0 || lane >= kLaneCount)
+    return;
+
+  // Store previous output for anti-click crossfade if voice was active
+  if (isActive (lane) && ampEnv_[lane] > 0.001)
+  {
+    antiClickLength_[lane] = antiClickLengthFor (sampleRate_);
+    antiClickSamples_[lane] = antiClickLength_[lane];
+  }
+  else
+  {
+    antiClickSamples_[lane] = 0;
+    antiClickLength_[lane] = 0;
+    antiClickPrevSample_[lane] = 0.0;
+    // Nothing audible is left to hand over: the fold's oversampler starts the new body clean.
+    foldOversampler_[lane].reset ();
+  }
+
+  const VoiceCoefficients laneCoefficients =
+    computeCoefficients (sanitizeFrame (frame), sampleRate_, controlInterval_);
+  loadCoefficients (lane, laneCoefficients);
+  forEachGainCoefficient (gainTarget_, coefficients_, [lane] (auto& target, const auto& gain) {
+    target[lane] = gain[lane];
+  });
+  endGainRamp (lane);
+  clickEnv_[lane] = 1.0;
+  const FilterCoefficients initial = filterCoefficientsAt (laneCoefficients, 0, sampleRate_, 1.0, 1.0, 1.0);
+  oscCoefTarget_[lane] = static_cast<Sample> (initial.osc);
+  transCoefTarget_[lane] = static_cast<Sample> (initial.trans);
+  noiseCoefTarget_[lane] = static_cast<Sample> (initial.noise);
+  controlCountdown_[lane] = 0;
+
+  // Clear filter states on trigger to prevent stale resonance
+  oscFilterLowState_[lane] = 0.0;
+  oscFilterBandState_[lane] = 0.0;
+  transFilterLowState_[lane] = 0.0;
+  transFilterBandState_[lane] = 0.0;
+  noiseResLowState_[lane] = 0.0;
+  noiseResBandState_[lane] = 0.0;
+
+  carrierPhase_[lane] = 0.0;
+  modPhase_[lane] = 0.0;
+  transientPhase_[lane] = 0.0;
+  // The restarted carrier sets off from a zero fold input.
+  foldPrevInput_[lane] = 0.0;
+
+  ampEnv_[lane] = 1.0;
+  toneEnv_[lane] = 1.0;
+  pitchEnv_[lane] = 1.0;
+  noiseEnv_[lane] = 1.0;
+  transientEnv_[lane] = 1.0;
+  paths_[lane] = audiblePaths (laneCoefficients, 0);
+  oscStages_[lane] = activeOscStages (laneCoefficients, 0);
+  activeMask_ |= laneBit (lane);
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::retune (int32 lane, const LaneFrame& frame)
+{
+  if (!isActive (lane))
+    return;
+
+  const VoiceCoefficients laneCoefficients =
+    computeCoefficients (sanitizeFrame (frame), sampleRate_, controlInterval_);
+  const auto copyLane = [lane] (auto& dest, const auto& source) { dest[lane] = source[lane]; };
+  // gainStep_ holds the gains the lane plays now while the new coefficients load, then becomes
+  // the per-sample step from them to the new gains.
+  forEachGainCoefficient (gainStep_, coefficients_, copyLane);
+  loadCoefficients (lane, laneCoefficients);
+  forEachGainCoefficient (gainTarget_, coefficients_, copyLane);
+  forEachGainCoefficient (coefficients_, gainStep_, copyLane);
+  const Sample stepScale = Sample (1) / static_cast<Sample> (controlInterval_);
+  forEachGainCoefficient (gainStep_, gainTarget_, [lane, stepScale] (auto& step, const auto& target) {
+    step[lane] = (target[lane] - step[lane]) * stepScale;
+  });
+  gainRamp_[lane] = controlInterval_;
+  oscStages_[lane] |= activeOscStages (laneCoefficients, 0);
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::processBlock (Block* out, int32 numSamples, uint32 laneMask)
+{
+  const uint32 renderMask = laneMask & activeMask_;
+  if (renderMask == 0)
+  {
+    std::fill (out, out + std::max (numSamples, 0), Block {});
+    return;
+  }
+  renderBlock (out, numSamples, renderMask);
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::renderBlock (Block* out, int32 numSamples, uint32 renderMask)
+{
+  const auto& c = coefficients_;
+  const double sampleRate = sampleRate_;
+  const int32 controlInterval = controlInterval_;
+  const Sample controlStepScale = Sample (1) / static_cast<Sample> (controlInterval);
+  const bool trackCoefficientError = trackCoefficientError_;
+  const bool antiAliasing = antiAliasing_;
+  const int32 latency = latency_;
+
+  // Running state is copied into locals so the kernel works on registers/stack rather than
+  // reloading members through `this` after every store to out.
+  LaneArray<double> carrierPhase = carrierPhase_;
+  LaneArray<double> modPhase = modPhase_;
+  LaneArray<double> transientPhase = transientPhase_;
+  const LaneArray<double> ampDecay = ampDecay_;
+  const LaneArray<double> toneDecay = toneDecay_;
+  const LaneArray<double> pitchDecay = pitchDecay_;
+  const LaneArray<double> noiseDecay = noiseDecay_;
+  const LaneArray<double> transientDecay = transientDecay_;
+  const LaneArray<double> clickDecay = clickDecay_;
+  LaneArray<Sample> ampEnv = ampEnv_;
+  LaneArray<Sample> toneEnv = toneEnv_;
+  LaneArray<Sample> pitchEnv = pitchEnv_;
+  LaneArray<Sample> noiseEnv = noiseEnv_;
+  LaneArray<Sample> transientEnv = transientEnv_;
+  LaneArray<Sample> clickEnv = clickEnv_;
+  LaneArray<Sample> noiseLowState = noiseLowState_;
+  LaneArray<Sample> noiseHighState = noiseHighState_;
+  LaneArray<Sample> noiseResLowState = noiseResLowState_;
+  LaneArray<Sample> noiseResBandState = noiseResBandState_;
+  LaneArray<Sample> oscFilterLowState = oscFilterLowState_;
+  LaneArray<Sample> oscFilterBandState = oscFilterBandState_;
+  LaneArray<Sample> transFilterLowState = transFilterLowState_;
+  LaneArray<Sample> transFilterBandState = transFilterBandState_;
+  LaneArray<int32_t> antiClickSamples = antiClickSamples_;
+  LaneArray<Sample> antiClickPrevSample = antiClickPrevSample_;
+  LaneArray<Sample> dcX = dcX_;
+  LaneArray<Sample> dcY = dcY_;
+  LaneArray<double> foldPrevInput = foldPrevInput_;
+  LaneArray<double> clipPrevInput = clipPrevInput_;
+  LaneArray<uint32_t> noiseState = noiseState_;
+  LaneArray<int32> controlCountdown = controlCountdown_;
+  LaneArray<Sample> oscCoef = oscCoef_;
+  LaneArray<Sample> oscCoefStep = oscCoefStep_;
+  LaneArray<Sample> oscCoefTarget = oscCoefTarget_;
+  LaneArray<Sample> transCoef = transCoef_;
+  LaneArray<Sample> transCoefStep = transCoefStep_;
+  LaneArray<Sample> transCoefTarget = transCoefTarget_;
+  LaneArray<Sample> noiseCoef = noiseCoef_;
+  LaneArray<Sample> noiseCoefStep = noiseCoefStep_;
+  LaneArray<Sample> noiseCoefTarget = noiseCoefTarget_;
+  LaneArray<uint32_t> paths = paths_;
+  LaneArray<int32> gainRamp = gainRamp_;
+
+  // Every lane runs through every loop below; lanes outside live (masked, or finished earlier in
+  // the block) compute too, but their results are discarded by the selects that commit state and
+  // output. Only the oversampled stages, which run their own filters per lane, and the
+  // control-rate filter updates visit lanes one at a time.
+  LaneArray<uint32_t> live {};
+  LaneArray<uint32_t> atBaseRate {};
+  LaneArray<uint32_t> foldAtBaseRate {};
+  LaneArray<int32> stageLatency {};
+  uint32 oversampledMask = 0;
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    live[lane] = (renderMask & laneBit (lane)) != 0 ? 1u : 0u;
+    atBaseRate[lane] = oversampling_[lane] == 1 ? 1u : 0u;
+    foldAtBaseRate[lane] = (oscStages_[lane] & kFoldStage) != 0 ? atBaseRate[lane] : 0u;
+    stageLatency[lane] = oversamplingLatency (oversampling_[lane]);
+    if (oversampling_[lane] > 1)
+      oversampledMask |= laneBit (lane);
+  }
+  uint32 liveMask = renderMask;
+
+  int32 sampleIndex = 0;
+  while (sampleIndex < numSamples && liveMask != 0)
+  {
+    // --- FILTER CONTROL ---
+    // Lanes whose ramp has run out get their next exact coefficients. The samples up to the
+    // earliest next update render without any per-lane control flow.
+    int32 run = numSamples - sampleIndex;
+    for (uint32 lanes = liveMask; lanes != 0; lanes &= lanes - 1)
+    {
+      const int32 lane = std::countr_zero (lanes);
+      if (controlCountdown[lane] == 0)
+      {
+        const FilterCoefficients next = filterCoefficientsAt (
+          c, lane, sampleRate, toneEnv[lane] * c.toneControlDecay[lane],
+          transientEnv[lane] * c.transientControlDecay[lane], noiseEnv[lane] * c.noiseControlDecay[lane]);
+        oscCoef[lane] = oscCoefTarget[lane];
+        transCoef[lane] = transCoefTarget[lane];
+        noiseCoef[lane] = noiseCoefTarget[lane];
+        const auto nextOsc = static_cast<Sample> (next.osc);
+        const auto nextTrans = static_cast<Sample> (next.trans);
+        const auto nextNoise = static_cast<Sample> (next.noise);
+        oscCoefStep[lane] = (nextOsc - oscCoefTarget[lane]) * controlStepScale;
+        transCoefStep[lane] = (nextTrans - transCoefTarget[lane]) * controlStepScale;
+        noiseCoefStep[lane] = (nextNoise - noiseCoefTarget[lane]) * controlStepScale;
+        oscCoefTarget[lane] = nextOsc;
+        transCoefTarget[lane] = nextTrans;
+        noiseCoefTarget[lane] = nextNoise;
+        controlCountdown[lane] = controlInterval;
+      }
+      run = std::min (run, controlCountdown[lane]);
+      if (gainRamp[lane] > 0)
+        run = std::min (run, gainRamp[lane]);
+    }
+
+    const uint32 runMask = liveMask;
+    const int32 runStart = sampleIndex;
+    // Paths only end within a run. A path no live lane still renders is skipped for the whole
+    // run; its lanes keep drawing from their noise sequences so a later hit hears the same noise.
+    uint32_t runPaths = 0;
+    for (uint32 lanes = liveMask; lanes != 0; lanes &= lanes - 1)
+      runPaths |= paths[std::countr_zero (lanes)];
+    const bool runTransient = (runPaths & kTransientPath) != 0;
+    const bool runNoise = (runPaths & kNoisePath) != 0;
+    bool runGainRamp = false;
+    for (uint32 lanes = liveMask; lanes != 0; lanes &= lanes - 1)
+      runGainRamp = runGainRamp || gainRamp[std::countr_zero (lanes)] > 0;
+    for (const int32 runEnd = sampleIndex + run; sampleIndex < runEnd && liveMask != 0; ++sampleIndex)
+    {
+      Block& frameOut = out[sampleIndex];
+
+      if (trackCoefficientError)
+      {
+        for (uint32 lanes = liveMask; lanes != 0; lanes &= lanes - 1)
+        {
+          const int32 lane = std::countr_zero (lanes);
+          accumulateCoefficientError (
+            coefficientError_, {oscCoef[lane], transCoef[lane], noiseCoef[lane]},
+            filterCoefficientsAt (c, lane, sampleRate, toneEnv[lane], transientEnv[lane], noiseEnv[lane]));
+        }
+      }
+
+      // --- OSCILLATOR PATH ---
+      // Every stage runs on every lane: with a zero amount the pitch sweep and FM are exact
+      // identities, and the fold is selected per lane.
+      LaneArray<Sample> pitchRatio {};
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        const Sample pitchSemitoneSweep = c.pitchEnvAmount[lane] * pitchEnv[lane] * c.pitchSemitoneSpan[lane];
+        pitchRatio[lane] = voiceExp2 (pitchSemitoneSweep / Sample (12));
+      }
+
+      // Frequencies may be Sample; the phase increments and accumulators are always double.
+      LaneArray<double> nextCarrierPhase {};
+      LaneArray<double> nextModPhase {};
+      LaneArray<double> nextTransientPhase {};
+      uint32_t pastTurn = 0;
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        const double carrierFrequency =
+          c.frequencyHz[lane] * pitchRatio[lane] * (Sample (1) + (toneEnv[lane] * Sample (0.07)));
+        const double carrier = carrierPhase[lane] + ((kTwoPi * carrierFrequency) / sampleRate);
+        nextCarrierPhase[lane] = selectLane (carrier >= kTwoPi, carrier - kTwoPi, carrier);
+
+        const double transient = transientPhase[lane] + c.transientIncrement[lane];
+        nextTransientPhase[lane] = selectLane (transient >= kTwoPi, transient - kTwoPi, transient);
+
+        const double modFrequency = c.frequencyHz[lane] * pitchRatio[lane] * c.modFrequencyScale[lane];
+        const double mod = modPhase[lane] + ((kTwoPi * modFrequency) / sampleRate);
+        nextModPhase[lane] = selectLane (mod >= kTwoPi, mod - kTwoPi, mod);
+
+        pastTurn |= static_cast<uint32_t> (nextCarrierPhase[lane] >= kTwoPi) |
+                    static_cast<uint32_t> (nextModPhase[lane] >= kTwoPi) |
+                    static_cast<uint32_t> (nextTransientPhase[lane] >= kTwoPi);
+      }
+      // An increment of a turn or more (extreme pitch sweeps) needs further wraps.
+      if (pastTurn != 0)
+      {
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+        {
+          nextCarrierPhase[lane] = wrapPhase (nextCarrierPhase[lane]);
+          nextModPhase[lane] = wrapPhase (nextModPhase[lane]);
+          nextTransientPhase[lane] = wrapPhase (nextTransientPhase[lane]);
+        }
+      }
+
+      LaneArray<Sample> body {};
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        // Thru-zero FM: modulation depth allows phase reversal (negative instantaneous freq)
+        const Sample fmDepth = c.fmAmount[lane] * ((Sample (12) * toneEnv[lane] * c.fmScale[lane]) + Sample (0.5));
+        const Sample modSignal = voiceSin (static_cast<Sample> (nextModPhase[lane])) * fmDepth;
+        body[lane] = voiceSin (static_cast<Sample> (nextCarrierPhase[lane] + modSignal));
+      }
+
+      LaneArray<uint32_t> oscFolded {};
+      LaneArray<Sample> foldGain {};
+      LaneArray<Sample> foldInput {};
+      LaneArray<Sample> folded {};
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        const Sample dynamicFold = c.foldAmount[lane] * (Sample (1.2) + (Sample (1.2) * toneEnv[lane]));
+        foldGain[lane] = wavefoldGain (dynamicFold);
+        foldInput[lane] = body[lane] * foldGain[lane];
+      }
+      if (antiAliasing)
+      {
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+          folded[lane] = wavefoldAntiAliased (foldInput[lane], foldPrevInput[lane]);
+      }
+      else
+      {
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+          folded[lane] = wavefold (foldInput[lane]);
+      }
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        const bool atRate = foldAtBaseRate[lane] != 0;
+        const bool renderFold = (live[lane] != 0) & ((paths[lane] & kOscPath) != 0) & atRate;
+        body[lane] = selectLane (atRate, folded[lane], body[lane]);
+        foldPrevInput[lane] = selectLane (renderFold, static_cast<double> (foldInput[lane]), foldPrevInput[lane]);
+      }
+
+      // Oversampled lanes fold through their own oversampler instead.
+      for (uint32 lanes = oversampledMask & liveMask; lanes != 0; lanes &= lanes - 1)
+      {
+        const int32 lane = std::countr_zero (lanes);
+        if ((paths[lane] & kOscPath) == 0 || (oscStages_[lane] & kFoldStage) == 0)
+          continue;
+        const auto fold = [&] (Sample x) {
+          const Sample input = x * foldGain[lane];
+          const Sample result = antiAliasing ? wavefoldAntiAliased (input, foldPrevInput[lane]) : wavefold (input);
+          foldPrevInput[lane] = input;
+          return result;
+        };
+        body[lane] = foldOversampler_[lane].process (body[lane], oversampling_[lane], fold);
+        oscFolded[lane] = 1u;
+      }
+
+      LaneArray<Sample> oscFilterCoef = oscCoef;
+      LaneArray<Sample> oscGate {};
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+        oscGate[lane] = ampEnv[lane] * (Sample (0.38) + (Sample (0.72) * toneEnv[lane]));
+
+      // A body folded through the oversampler comes back stageLatency samples late; the filter
+      // sweep and gate it meets are held back as long. The delays run for every oversampled lane,
+      // so a fold that starts mid-hit (a retuned lane) finds them filled.
+      for (uint32 lanes = oversampledMask & liveMask; lanes != 0; lanes &= lanes - 1)
+      {
+        const int32 lane = std::countr_zero (lanes);
+        const Sample delayedCoef = oscCoefDelay_[lane].process (oscCoef[lane], stageLatency[lane]);
+        const Sample delayedGate = oscGateDelay_[lane].process (oscGate[lane], stageLatency[lane]);
+        if (oscFolded[lane] != 0)
+        {
+          oscFilterCoef[lane] = delayedCoef;
+          oscGate[lane] = delayedGate;
+        }
+      }
+
+      LaneArray<Sample> oscOut {};
+      LaneArray<uint32_t> endedPaths {};
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        const bool renderOsc = (live[lane] != 0) & ((paths[lane] & kOscPath) != 0);
+        const Sample prevLow = oscFilterLowState[lane];
+        const Sample prevBand = oscFilterBandState[lane];
+        Sample lowState = prevLow;
+        Sample bandState = prevBand;
+        const Sample filtered =
+          stateVariableLowpass (body[lane], oscFilterCoef[lane], c.oscDamping[lane], lowState, bandState);
+        const Sample rendered = filtered * c.oscLevel[lane] * oscGate[lane] * c.bodyGain[lane] * Sample (1.41);
+        oscOut[lane] = selectLane (renderOsc, rendered, Sample (0));
+
+        // Decayed below the floor: stop rendering the path and flush its filter.
+        const bool ends = renderOsc & (ampEnv[lane] < kVoiceEnvFloor);
+        oscFilterLowState[lane] = selectLane (ends, Sample (0), selectLane (renderOsc, lowState, prevLow));
+        oscFilterBandState[lane] = selectLane (ends, Sample (0), selectLane (renderOsc, bandState, prevBand));
+        endedPaths[lane] = selectLane (ends, kOscPath, 0u);
+      }
+
+      // --- TRANSIENT AND NOISE SOURCES ---
+      // Both paths draw from the lane's noise sequence every sample, rendering or not.
+      LaneArray<Sample> transientNoise {};
+      LaneArray<Sample> rawNoise {};
+      if (runTransient | runNoise)
+      {
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+        {
+          uint32_t state = noiseState[lane];
+          transientNoise[lane] = randomBipolar<Sample> (state);
+          rawNoise[lane] = randomBipolar<Sample> (state);
+          noiseState[lane] = selectLane (live[lane] != 0, state, noiseState[lane]);
+        }
+      }
+      else
+      {
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+        {
+          uint32_t state = noiseState[lane];
+          advanceRandom (state);
+          advanceRandom (state);
+          noiseState[lane] = selectLane (live[lane] != 0, state, noiseState[lane]);
+        }
+      }
+
+      // --- TRANSIENT PATH ---
+      LaneArray<Sample> transOut {};
+      if (runTransient)
+      {
+        LaneArray<Sample> transientOsc {};
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+          transientOsc[lane] = voiceSin (static_cast<Sample> (nextTransientPhase[lane]));
+
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+        {
+          const bool renderTransient = (live[lane] != 0) & ((paths[lane] & kTransientPath) != 0);
+          const Sample transientBlend = c.transientBlend[lane];
+          const Sample transientCore =
+            (transientOsc[lane] * (Sample (1) - transientBlend)) + (transientNoise[lane] * transientBlend);
+
+          const Sample prevLow = transFilterLowState[lane];
+          const Sample prevBand = transFilterBandState[lane];
+          Sample lowState = prevLow;
+          Sample bandState = prevBand;
+          const Sample filteredTransient =
+            stateVariableLowpass (transientCore, transCoef[lane], c.transDamping[lane], lowState, bandState);
+
+          const Sample transientGain = c.transientGain[lane];
+          const Sample clickAmt = c.clickDepth[lane] * transientEnv[lane];
+          const Sample click = clickEnv[lane];
+          const Sample clickOut = transientCore * click * clickAmt * transientGain;
+          const Sample rendered = (filteredTransient * transientEnv[lane] * transientGain) + clickOut;
+          const Sample decayedClick = static_cast<Sample> (click * clickDecay[lane]);
+          transOut[lane] = selectLane (renderTransient, rendered, Sample (0));
+          clickEnv[lane] = selectLane (renderTransient, decayedClick, click);
+
+          // The click layer is scaled by transientEnv too, so the whole path ends with it.
+          const bool ends = renderTransient & (transientEnv[lane] < kVoiceEnvFloor);
+          transFilterLowState[lane] = selectLane (ends, Sample (0), selectLane (renderTransient, lowState, prevLow));
+          transFilterBandState[lane] = selectLane (ends, Sample (0), selectLane (renderTransient, bandState, prevBand));
+          endedPaths[lane] |= selectLane (ends, kTransientPath, 0u);
+        }
+      }
+
+      // --- NOISE PATH ---
+      LaneArray<Sample> noiseOut {};
+      if (runNoise)
+      {
+        LaneArray<Sample> contour {};
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+          contour[lane] = noiseContour (noiseEnv[lane], c.snapAmount[lane], c.snapExponent[lane]);
+
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+        {
+          const bool renderNoise = (live[lane] != 0) & ((paths[lane] & kNoisePath) != 0);
+          const Sample prevNoiseLow = noiseLowState[lane];
+          const Sample prevNoiseHigh = noiseHighState[lane];
+          const Sample noiseLow = prevNoiseLow + (c.noiseLpCoef[lane] * (rawNoise[lane] - prevNoiseLow));
+          const Sample noiseHigh = prevNoiseHigh + (c.noiseHpCoef[lane] * (rawNoise[lane] - prevNoiseHigh));
+          const Sample highNoise = rawNoise[lane] - noiseHigh;
+          const Sample toneBlend = c.toneBlend[lane];
+          const Sample shapedNoise = ((Sample (1) - toneBlend) * noiseLow) + (toneBlend * highNoise);
+
+          const Sample prevLow = noiseResLowState[lane];
+          const Sample prevBand = noiseResBandState[lane];
+          Sample lowState = prevLow;
+          Sample bandState = prevBand;
+          const Sample resonantNoise =
+            stateVariableLowpass (shapedNoise, noiseCoef[lane], c.noiseDamping[lane], lowState, bandState);
+          const Sample rendered =
+            resonantNoise * c.noiseAmount[lane] * c.noiseLevel[lane] * contour[lane] * c.noiseBlendGain[lane];
+          noiseOut[lane] = selectLane (renderNoise, rendered, Sample (0));
+
+          const bool ends = renderNoise & (contour[lane] < kVoiceEnvFloor);
+          noiseLowState[lane] = selectLane (ends, Sample (0), selectLane (renderNoise, noiseLow, prevNoiseLow));
+          noiseHighState[lane] = selectLane (ends, Sample (0), selectLane (renderNoise, noiseHigh, prevNoiseHigh));
+          noiseResLowState[lane] = selectLane (ends, Sample (0), selectLane (renderNoise, lowState, prevLow));
+          noiseResBandState[lane] = selectLane (ends, Sample (0), selectLane (renderNoise, bandState, prevBand));
+          endedPaths[lane] |= selectLane (ends, kNoisePath, 0u);
+        }
+      }
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+        paths[lane] &= ~endedPaths[lane];
+
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        const bool advance = live[lane] != 0;
+        const Sample nextOscCoef = oscCoef[lane] + oscCoefStep[lane];
+        const Sample nextTransCoef = transCoef[lane] + transCoefStep[lane];
+        const Sample nextNoiseCoef = noiseCoef[lane] + noiseCoefStep[lane];
+        carrierPhase[lane] = selectLane (advance, nextCarrierPhase[lane], carrierPhase[lane]);
+        modPhase[lane] = selectLane (advance, nextModPhase[lane], modPhase[lane]);
+        transientPhase[lane] = selectLane (advance, nextTransientPhase[lane], transientPhase[lane]);
+        oscCoef[lane] = selectLane (advance, nextOscCoef, oscCoef[lane]);
+        transCoef[lane] = selectLane (advance, nextTransCoef, transCoef[lane]);
+        noiseCoef[lane] = selectLane (advance, nextNoiseCoef, noiseCoef[lane]);
+      }
+
+      // --- SUMMING (per-voice, no dynamic normalization) ---
+      LaneArray<Sample> clipInput {};
+      LaneArray<Sample> clipped {};
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        const Sample rawMix = oscOut[lane] + noiseOut[lane] + transOut[lane];
+        clipInput[lane] = rawMix * c.drive[lane];
+      }
+      if (antiAliasing)
+      {
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+          clipped[lane] = softClipAntiAliased (clipInput[lane], clipPrevInput[lane]);
+      }
+      else
+      {
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+          clipped[lane] = softClip (clipInput[lane]);
+      }
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        const bool renderClip = (live[lane] != 0) & (atBaseRate[lane] != 0);
+        clipPrevInput[lane] = selectLane (renderClip, static_cast<double> (clipInput[lane]), clipPrevInput[lane]);
+      }
+
+      // Oversampled lanes clip through their own oversampler; paths that skipped the oversampled
+      // fold wait out its latency before the mix.
+      for (uint32 lanes = oversampledMask & liveMask; lanes != 0; lanes &= lanes - 1)
+      {
+        const int32 lane = std::countr_zero (lanes);
+        const auto clip = [&] (Sample x) {
+          const Sample result = antiAliasing ? softClipAntiAliased (x, clipPrevInput[lane]) : softClip (x);
+          clipPrevInput[lane] = x;
+          return result;
+        };
+        const Sample foldedOut = oscFolded[lane] != 0 ? oscOut[lane] : Sample (0);
+        const Sample directOut = (oscFolded[lane] != 0 ? Sample (0) : oscOut[lane]) + noiseOut[lane] + transOut[lane];
+        const Sample rawMix = foldedOut + pathDelay_[lane].process (directOut, stageLatency[lane]);
+        clipped[lane] = clipOversampler_[lane].process (rawMix * c.drive[lane], oversampling_[lane], clip);
+        if ((endedPaths[lane] & kOscPath) != 0)
+          foldOversampler_[lane].reset ();
+      }
+
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        const bool advance = live[lane] != 0;
+        Sample sample = clipped[lane] * c.outputLevel[lane];
+
+        // Anti-click crossfade: blend previous tail with new attack
+        const int32_t remaining = antiClickSamples[lane];
+        const int32_t length = antiClickLength_[lane];
+        const Sample prevSample = antiClickPrevSample[lane];
+        const bool crossfade = (remaining > 0) & (length > 0);
+        const Sample fade = static_cast<Sample> (remaining) / static_cast<Sample> (std::max (length, int32_t {1}));
+        const Sample blended = sample * (Sample (1) - fade) + prevSample * fade;
+        sample = selectLane (crossfade, blended, sample);
+        const bool fading = crossfade & advance;
+        antiClickPrevSample[lane] = selectLane (fading, prevSample * Sample (0.92), prevSample);
+        antiClickSamples[lane] = remaining - static_cast<int32_t> (fading);
+
+        const Sample dcOut = sample - dcX[lane] + Sample (kDcCoef) * dcY[lane];
+        dcY[lane] = selectLane (advance, dcOut, dcY[lane]);
+        dcX[lane] = selectLane (advance, sample, dcX[lane]);
+        frameOut[lane] = selectLane (advance, dcOut, Sample (0));
+      }
+      if (latency > 0)
+      {
+        for (uint32 lanes = liveMask; lanes != 0; lanes &= lanes - 1)
+        {
+          const int32 lane = std::countr_zero (lanes);
+          frameOut[lane] = alignDelay_[lane].process (frameOut[lane], latency - (2 * stageLatency[lane]));
+        }
+      }
+
+      // --- ENVELOPE DECAY ---
+      uint32 finished = 0;
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        const bool advance = live[lane] != 0;
+        const Sample amp = static_cast<Sample> (ampEnv[lane] * ampDecay[lane]);
+        const Sample tone = static_cast<Sample> (toneEnv[lane] * toneDecay[lane]);
+        const Sample pitch = static_cast<Sample> (pitchEnv[lane] * pitchDecay[lane]);
+        const Sample noise = static_cast<Sample> (noiseEnv[lane] * noiseDecay[lane]);
+        const Sample transient = static_cast<Sample> (transientEnv[lane] * transientDecay[lane]);
+
+        const bool allBelowFloor = (amp < kVoiceEnvFloor) & (noise < kVoiceEnvFloor) &
+                                   (transient < kVoiceEnvFloor) & (clickEnv[lane] < kVoiceClickFloor);
+        const bool ends = advance & (allBelowFloor | (paths[lane] == 0));
+        ampEnv[lane] = selectLane (ends, Sample (0), selectLane (advance, amp, ampEnv[lane]));
+        toneEnv[lane] = selectLane (ends, Sample (0), selectLane (advance, tone, toneEnv[lane]));
+        pitchEnv[lane] = selectLane (ends, Sample (0), selectLane (advance, pitch, pitchEnv[lane]));
+        noiseEnv[lane] = selectLane (ends, Sample (0), selectLane (advance, noise, noiseEnv[lane]));
+        transientEnv[lane] = selectLane (ends, Sample (0), selectLane (advance, transient, transientEnv[lane]));
+        clickEnv[lane] = selectLane (ends, Sample (0), clickEnv[lane]);
+        // Nothing reads the filter and DC blocker states again before the next trigger; flushing
+        // them here keeps their ring-down out of the denormal range.
+        noiseLowState[lane] = selectLane (ends, Sample (0), noiseLowState[lane]);
+        noiseHighState[lane] = selectLane (ends, Sample (0), noiseHighState[lane]);
+        noiseResLowState[lane] = selectLane (ends, Sample (0), noiseResLowState[lane]);
+        noiseResBandState[lane] = selectLane (ends, Sample (0), noiseResBandState[lane]);
+        oscFilterLowState[lane] = selectLane (ends, Sample (0), oscFilterLowState[lane]);
+        oscFilterBandState[lane] = selectLane (ends, Sample (0), oscFilterBandState[lane]);
+        transFilterLowState[lane] = selectLane (ends, Sample (0), transFilterLowState[lane]);
+        transFilterBandState[lane] = selectLane (ends, Sample (0), transFilterBandState[lane]);
+        antiClickPrevSample[lane] = selectLane (ends, Sample (0), antiClickPrevSample[lane]);
+        dcX[lane] = selectLane (ends, Sample (0), dcX[lane]);
+        dcY[lane] = selectLane (ends, Sample (0), dcY[lane]);
+        live[lane] = selectLane (ends, 0u, live[lane]);
+        finished |= selectLane (ends, laneBit (lane), 0u);
+      }
+
+      // Retuned gains move one step per sample; lanes with no ramp add zero.
+      if (runGainRamp)
+      {
+        forEachGainCoefficient (coefficients_, gainStep_, [&live] (auto& gain, const auto& step) {
+          for (int32 lane = 0; lane < kLaneCount; ++lane)
+            gain[lane] = selectLane (live[lane] != 0, gain[lane] + step[lane], gain[lane]);
+        });
+      }
+
+      if (finished != 0)
+      {
+        liveMask &= ~finished;
+        activeMask_ &= ~finished;
+        if (latency > 0)
+        {
+          for (uint32 lanes = finished; lanes != 0; lanes &= lanes - 1)
+            resetOversampling (std::countr_zero (lanes));
+        }
+      }
+    }
+
+    const int32 rendered = sampleIndex - runStart;
+    for (uint32 lanes = runMask; lanes != 0; lanes &= lanes - 1)
+    {
+      const int32 lane = std::countr_zero (lanes);
+      controlCountdown[lane] -= rendered;
+      if (gainRamp[lane] > 0)
+      {
+        gainRamp[lane] -= rendered;
+        if (gainRamp[lane] <= 0)
+          endGainRamp (lane);
+      }
+    }
+  }
+
+  // Every lane finished mid-block: the remainder is silent.
+  for (; sampleIndex < numSamples; ++sampleIndex)
+    out[sampleIndex] = Block {};
+
+  carrierPhase_ = carrierPhase;
+  modPhase_ = modPhase;
+  transientPhase_ = transientPhase;
+  ampEnv_ = ampEnv;
+  toneEnv_ = toneEnv;
+  pitchEnv_ = pitchEnv;
+  noiseEnv_ = noiseEnv;
+  transientEnv_ = transientEnv;
+  clickEnv_ = clickEnv;
+  noiseLowState_ = noiseLowState;
+  noiseHighState_ = noiseHighState;
+  noiseResLowState_ = noiseResLowState;
+  noiseResBandState_ = noiseResBandState;
+  oscFilterLowState_ = oscFilterLowState;
+  oscFilterBandState_ = oscFilterBandState;
+  transFilterLowState_ = transFilterLowState;
+  transFilterBandState_ = transFilterBandState;
+  antiClickSamples_ = antiClickSamples;
+  antiClickPrevSample_ = antiClickPrevSample;
+  dcX_ = dcX;
+  dcY_ = dcY;
+  foldPrevInput_ = foldPrevInput;
+  clipPrevInput_ = clipPrevInput;
+  noiseState_ = noiseState;
+  controlCountdown_ = controlCountdown;
+  oscCoef_ = oscCoef;
+  oscCoefStep_ = oscCoefStep;
+  oscCoefTarget_ = oscCoefTarget;
+  transCoef_ = transCoef;
+  transCoefStep_ = transCoefStep;
+  transCoefTarget_ = transCoefTarget;
+  noiseCoef_ = noiseCoef;
+  noiseCoefStep_ = noiseCoefStep;
+  noiseCoefTarget_ = noiseCoefTarget;
+  paths_ = paths;
+  gainRamp_ = gainRamp;
+}
+
+template <typename Sample>
+void DrumVoiceBankT<Sample>::reset ()
+{
+  carrierPhase_.fill (0.0);
+  modPhase_.fill (0.0);
+  transientPhase_.fill (0.0);
+  ampEnv_.fill (0.0);
+  toneEnv_.fill (0.0);
+  pitchEnv_.fill (0.0);
+  noiseEnv_.fill (0.0);
+  transientEnv_.fill (0.0);
+  clickEnv_.fill (0.0);
+  noiseLowState_.fill (0.0);
+  noiseHighState_.fill (0.0);
+  noiseResLowState_.fill (0.0);
+  noiseResBandState_.fill (0.0);
+  oscFilterLowState_.fill (0.0);
+  oscFilterBandState_.fill (0.0);
+  transFilterLowState_.fill (0.0);
+  transFilterBandState_.fill (0.0);
+  antiClickSamples_.fill (0);
+  antiClickLength_.fill (0);
+  antiClickPrevSample_.fill (0.0);
+  dcX_.fill (0.0);
+  dcY_.fill (0.0);
+  foldPrevInput_.fill (0.0);
+  clipPrevInput_.fill (0.0);
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+    resetOversampling (lane);
+  controlCountdown_.fill (0);
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+    endGainRamp (lane);
+  paths_.fill (0);
+  activeMask_ = 0;
+}
+
+template <typename Sample>
+bool DrumVoiceBankT<Sample>::isActive (int32 lane) const
+{
+  if (lane < 0 || lane >= kLaneCount)
+    return false;
+  return (activeMask_ & laneBit (lane)) != 0;
+}
+
+template <typename Sample>
+uint32 DrumVoiceBankT<Sample>::activeMask () const
+{
+  return activeMask_;
+}
+
+template <typename Sample>
+uint32 DrumVoiceBankT<Sample>::tailSamples () const
+{
+  double longest = 0.0;
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    if ((activeMask_ & laneBit (lane)) == 0)
+      continue;
+    const LaneEnvelopes envelopes {ampEnv_[lane], noiseEnv_[lane], transientEnv_[lane], clickEnv_[lane]};
+    longest = std::max (longest, samplesUntilSilent (coefficients_, static_cast<size_t> (lane), paths_[lane],
+                                                     envelopes));
+  }
+  return static_cast<uint32> (std::min (std::ceil (longest) + 1.0 + latency_, 1.0e9));
+}
+
+template <typename Sample>
+uint32 DrumVoiceBankT<Sample>::tailSamplesFor (const std::array<LaneFrame, kLaneCount>& frames) const
+{
+  double longest = 0.0;
+  for (const LaneFrame& frame : frames)
+  {
+    const VoiceCoefficients c = computeCoefficients (sanitizeFrame (frame), sampleRate_, controlInterval_);
+    longest = std::max (longest, samplesUntilSilent (c, 0, audiblePaths (c, 0), LaneEnvelopes {}));
+  }
+  return static_cast<uint32> (std::min (std::ceil (longest) + 1.0 + latency_, 1.0e9));
+}
+
+template class DrumVoiceBankT<double>;
+template class DrumVoiceBankT<float>;
+
+} // namespace Steinberg::WestCoastDrumSynth
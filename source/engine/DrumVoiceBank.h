@@ -0,0 +1,159 @@
+#pragma once
+
+#include "ParameterIds.h"
+#include "engine/LaneFrame.h"
+#include "engine/Oversampler.h"
+#include "engine/VoiceDsp.h"
+
+#include <array>
+#include <cstdint>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+template <typename T>
+using LaneArray = std::array<T, kLaneCount>;
+using LaneSamples = LaneArray<double>;
+
+// All kLaneCount drum voices stored as structure-of-arrays: every phase, envelope, filter and noise
+// state is a LaneArray indexed by lane, so one kernel advances the whole kit sample by sample.
+// Sample is the internal precision of envelopes, filters and output; the phase accumulators and
+// envelope decay coefficients stay double. The kernel is branch-free across lanes: every lane runs
+// every stage and lanes that are not rendering are masked out with VoiceDsp::selectLane. Only
+// whole paths drop out: the transient and noise paths are skipped while no rendering lane has them.
+template <typename Sample>
+class DrumVoiceBankT {
+public:
+  using Block = LaneArray<Sample>;
+
+  DrumVoiceBankT ();
+
+  void setSampleRate (double sampleRate);
+  // Number of samples between exact filter-coefficient evaluations (1 = every sample).
+  void setControlInterval (int32 samples);
+  int32 controlInterval () const;
+  // When enabled, every rendered sample also computes the exact coefficients and records how far
+  // the interpolated ones deviate. Diagnostic only; costs the per-sample sin calls it saves.
+  void setCoefficientErrorTracking (bool enabled);
+  // Renders wavefold and softClip through their VoiceDsp ADAA forms; takes effect immediately.
+  void setAntiAliasing (bool enabled);
+  // Runs lane's wavefold and drive clipper at factor (1, 2 or 4) times the sample rate. A change
+  // clears the lane's oversampling state; every lane is delayed to the bank's latencySamples ().
+  void setOversampling (int32 lane, int32 factor);
+  uint32 latencySamples () const;
+  const VoiceDsp::CoefficientErrorStats& coefficientErrorStats () const;
+  void resetCoefficientErrorStats ();
+  void trigger (int32 lane, const LaneFrame& frame);
+  // Moves a sounding lane onto frame without restarting it: phases, envelopes and filter states
+  // carry on. The gain coefficients ramp to frame's over one control interval and the filters
+  // glide to it from their next control step; the rest moves at once. A fold frame adds comes in
+  // on the lane; paths the hit did not start with stay silent.
+  void retune (int32 lane, const LaneFrame& frame);
+  // Writes numSamples frames of per-lane output. Only active lanes in laneMask advance; every
+  // other lane outputs silence and keeps its state (a muted lane resumes where it stopped).
+  void processBlock (Block* out, int32 numSamples, uint32 laneMask);
+  void reset ();
+  bool isActive (int32 lane) const;
+  uint32 activeMask () const;
+  // Upper bound on the samples until every active lane has decayed to silence.
+  uint32 tailSamples () const;
+  // Upper bound on the samples a hit of any of frames rings for, at the current sample rate and
+  // latency; stable while the frames are, unlike tailSamples ().
+  uint32 tailSamplesFor (const std::array<LaneFrame, kLaneCount>& frames) const;
+
+private:
+  void renderBlock (Block* out, int32 numSamples, uint32 renderMask);
+
+  double sampleRate_ {44100.0};
+  VoiceDsp::VoiceCoefficientsT<LaneArray<Sample>> coefficients_ {};
+
+  int32 controlInterval_ {VoiceDsp::kDefaultControlInterval};
+  LaneArray<int32> controlCountdown_ {};
+  LaneArray<Sample> oscCoef_ {};
+  LaneArray<Sample> oscCoefStep_ {};
+  LaneArray<Sample> oscCoefTarget_ {};
+  LaneArray<Sample> transCoef_ {};
+  LaneArray<Sample> transCoefStep_ {};
+  LaneArray<Sample> transCoefTarget_ {};
+  LaneArray<Sample> noiseCoef_ {};
+  LaneArray<Sample> noiseCoefStep_ {};
+  LaneArray<Sample> noiseCoefTarget_ {};
+  // Gain coefficients (VoiceDsp::forEachGainCoefficient) ramping after a retune: gainStep_ is
+  // added every sample until gainRamp_ runs out, then the lane lands on gainTarget_ exactly.
+  VoiceDsp::VoiceCoefficientsT<LaneArray<Sample>> gainTarget_ {};
+  VoiceDsp::VoiceCoefficientsT<LaneArray<Sample>> gainStep_ {};
+  LaneArray<int32> gainRamp_ {};
+  bool trackCoefficientError_ {false};
+  VoiceDsp::CoefficientErrorStats coefficientError_ {};
+  // Per-sample envelope decays, double whatever Sample is: rounded to float, a coefficient this
+  // close to 1 moves the decay time by up to a percent, which the pitch sweep and the fold turn
+  // into audible drift from the double reference.
+  LaneArray<double> ampDecay_ {};
+  LaneArray<double> toneDecay_ {};
+  LaneArray<double> pitchDecay_ {};
+  LaneArray<double> noiseDecay_ {};
+  LaneArray<double> transientDecay_ {};
+  LaneArray<double> clickDecay_ {};
+
+  LaneArray<double> carrierPhase_ {};
+  LaneArray<double> modPhase_ {};
+  LaneArray<double> transientPhase_ {};
+
+  LaneArray<Sample> ampEnv_ {};
+  LaneArray<Sample> toneEnv_ {};
+  LaneArray<Sample> pitchEnv_ {};
+  LaneArray<Sample> noiseEnv_ {};
+  LaneArray<Sample> transientEnv_ {};
+  LaneArray<Sample> clickEnv_ {};
+
+  LaneArray<Sample> noiseLowState_ {};
+  LaneArray<Sample> noiseHighState_ {};
+  LaneArray<Sample> noiseResLowState_ {};
+  LaneArray<Sample> noiseResBandState_ {};
+  LaneArray<Sample> oscFilterLowState_ {};
+  LaneArray<Sample> oscFilterBandState_ {};
+  LaneArray<Sample> transFilterLowState_ {};
+  LaneArray<Sample> transFilterBandState_ {};
+
+  LaneArray<int32_t> antiClickSamples_ {};
+  LaneArray<int32_t> antiClickLength_ {};
+  LaneArray<Sample> antiClickPrevSample_ {};
+
+  LaneArray<Sample> dcX_ {};
+  LaneArray<Sample> dcY_ {};
+
+  // Previous fold and clipper inputs for the ADAA forms, kept in either mode so switching is seamless.
+  bool antiAliasing_ {false};
+  LaneArray<double> foldPrevInput_ {};
+  LaneArray<double> clipPrevInput_ {};
+
+  // Per-lane oversampling around the fold and the clipper. pathDelay_ holds the paths that skip
+  // the fold back by its latency; oscCoefDelay_ and oscGateDelay_ hold back the osc filter
+  // coefficient and gate the folded body meets after the fold. alignDelay_ pads each lane to
+  // latency_, the slowest lane's.
+  LaneArray<int32> oversampling_ {};
+  int32 latency_ {0};
+  LaneArray<HalfBandOversampler<Sample>> foldOversampler_ {};
+  LaneArray<HalfBandOversampler<Sample>> clipOversampler_ {};
+  LaneArray<SampleDelay<Sample>> pathDelay_ {};
+  LaneArray<SampleDelay<Sample>> oscCoefDelay_ {};
+  LaneArray<SampleDelay<Sample>> oscGateDelay_ {};
+  LaneArray<SampleDelay<Sample>> alignDelay_ {};
+
+  LaneArray<uint32_t> noiseState_ {};
+  // VoiceDsp path bits still rendering, per lane
+  LaneArray<uint32_t> paths_ {};
+  // VoiceDsp osc stages with a non-zero amount, per lane
+  LaneArray<uint32_t> oscStages_ {};
+  uint32 activeMask_ {0};
+
+  void loadCoefficients (int32 lane, const VoiceDsp::VoiceCoefficients& laneCoefficients);
+  void endGainRamp (int32 lane);
+  void resetOversampling (int32 lane);
+};
+
+extern template class DrumVoiceBankT<double>;
+extern template class DrumVoiceBankT<float>;
+
+using DrumVoiceBank = DrumVoiceBankT<double>;
+
+} // namespace Steinberg::WestCoastDrumSynth
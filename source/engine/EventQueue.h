@@ -0,0 +1,84 @@
+#pragma once
+
+#include "ParameterIds.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+struct TriggerEvent {
+  int32 sampleOffset {0};
+  int32 lane {0};
+};
+
+struct ParameterEvent {
+  int32 sampleOffset {0};
+  Vst::ParamID id {0};
+  double value {0.0};
+};
+
+// Timed events of one process () call in fixed preallocated storage. Events are pushed in
+// arrival order and sorted by sample offset once per block; events sharing an offset keep their
+// push order, so a block replays exactly as if every event had been applied at its sample in
+// arrival order. push () refuses events past Capacity.
+template <typename Event, int32 Capacity>
+class FixedEventQueue {
+public:
+  static constexpr int32 kCapacity = Capacity;
+
+  void clear ()
+  {
+    size_ = 0;
+  }
+
+  bool push (const Event& event)
+  {
+    if (size_ >= kCapacity)
+      return false;
+    order_[size_] = size_;
+    events_[size_++] = event;
+    return true;
+  }
+
+  // Sorts an index permutation (ties broken by push index), so this is stable without the
+  // scratch buffer std::stable_sort would allocate.
+  void sort ()
+  {
+    std::sort (order_.begin (), order_.begin () + size_, [this] (int32 a, int32 b)
+    {
+      const int32 offsetA = events_[a].sampleOffset;
+      const int32 offsetB = events_[b].sampleOffset;
+      return offsetA != offsetB ? offsetA < offsetB : a < b;
+    });
+  }
+
+  bool empty () const
+  {
+    return size_ == 0;
+  }
+
+  int32 size () const
+  {
+    return size_;
+  }
+
+  // The index-th event in sorted order.
+  const Event& operator[] (int32 index) const
+  {
+    return events_[order_[index]];
+  }
+
+private:
+  std::array<Event, Capacity> events_ {};
+  std::array<int32, Capacity> order_ {};
+  int32 size_ {0};
+};
+
+using TriggerEventQueue = FixedEventQueue<TriggerEvent, 1024>;
+using ParameterEventQueue = FixedEventQueue<ParameterEvent, 2048>;
+// The final point of each parameter whose points did not all fit a ParameterEventQueue; a block
+// holds at most one change list per parameter.
+using ParameterOverflowQueue = FixedEventQueue<ParameterEvent, kTotalParameterCount>;
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+namespace Steinberg::WestCoastDrumSynth::FastMath {
+
+// Polynomial approximations of the transcendentals used by the voice render loop. All are
+// constexpr and free of branches, so a fixed-width loop over the voice bank's lanes vectorizes
+// through them; they are accurate far below audibility, and the bounds below were measured by
+// sweeping each function against libm over the stated range.
+//
+//   exp2   x in [-1022, 1023]                 relative error < 1e-11
+//   log2   x in [1/2, 2]                      absolute error < 1e-15
+//          x > 0 (normal)                     absolute error < 1.2e-13 (one ulp of results beyond +-512)
+//   pow    base in [0, 2], exponent in [0, 3] relative error < 1e-11
+//   sin    |x| < 1e6                          absolute error < 1e-11
+//   tanh   any x                              absolute error < 5e-12
+//
+// tests/FastMathTests.cpp repeats the sweeps.
+
+namespace Detail {
+
+constexpr double kLn2 = 0.69314718055994530942;
+constexpr double kInvLn2 = 1.44269504088896340736;
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kHalfPi = 1.57079632679489661923;
+constexpr double kInvTwoPi = 0.15915494309189533577;
+constexpr double kSqrtHalf = 0.70710678118654752440;
+
+// 2 pi split for Cody-Waite reduction: kTwoPiHigh keeps 33 significant bits, so k * kTwoPiHigh is
+// exact for |k| < 2^20, and kTwoPiLow is the rest of 2 pi.
+constexpr double kTwoPiHigh = 6.2831853069365025;
+constexpr double kTwoPiLow = 2.430840202602477e-10;
+
+// 1.5 * 2^52. Adding it to a double of magnitude below 2^51 rounds that to the nearest integer,
+// which then sits in the low bits of the sum's mantissa; no float-to-int conversion is needed, so
+// the functions below vectorize on targets without 64-bit integer conversions.
+constexpr double kRoundingBias = 6755399441055744.0;
+
+constexpr double roundToNearest (double x)
+{
+  return (x + kRoundingBias) - kRoundingBias;
+}
+
+} // namespace Detail
+
+// 2^x: split into integer and fractional parts, evaluate 2^f for f in [-0.5, 0.5] with a
+// degree-9 Taylor polynomial of e^(f ln2) in Estrin form and rebuild the exponent bits directly.
+// Out-of-range inputs are clamped and selected rather than branched on, so the whole body
+// vectorizes across lanes.
+constexpr double exp2 (double x)
+{
+  const double clamped = std::clamp (x, -1022.0, 1023.0);
+  const double biased = clamped + Detail::kRoundingBias;
+  const double whole = biased - Detail::kRoundingBias;
+  const double t = (clamped - whole) * Detail::kLn2;
+
+  const double t2 = t * t;
+  const double t4 = t2 * t2;
+  const double p01 = 1.0 + t;
+  const double p23 = 0.5 + t * (1.0 / 6.0);
+  const double p45 = (1.0 / 24.0) + t * (1.0 / 120.0);
+  const double p67 = (1.0 / 720.0) + t * (1.0 / 5040.0);
+  const double p89 = (1.0 / 40320.0) + t * (1.0 / 362880.0);
+  const double p = (p01 + t2 * p23) + t4 * ((p45 + t2 * p67) + t4 * p89);
+
+  // The low 12 bits of biased hold whole in two's complement; whole + 1023 is the exponent field.
+  const double scale = std::bit_cast<double> ((std::bit_cast<uint64_t> (biased) + 1023) << 52);
+  return x < -1022.0 ? 0.0 : p * scale;
+}
+
+// log2 (x) for positive normal x: exponent from the bits, mantissa m in [sqrt(1/2), sqrt(2))
+// through the atanh series of ln (m) in s = (m - 1) / (m + 1).
+constexpr double log2 (double x)
+{
+  const uint64_t bits = std::bit_cast<uint64_t> (x);
+  const double unitMantissa = std::bit_cast<double> ((bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL);
+  const bool upperHalf = unitMantissa > 2.0 * Detail::kSqrtHalf;
+  const double mantissa = upperHalf ? unitMantissa * 0.5 : unitMantissa;
+  // The biased exponent as a double: placed in the mantissa of 2^52 and the 2^52 subtracted again.
+  const double biasedExponent =
+    std::bit_cast<double> (((bits >> 52) & 0x7FF) | 0x4330000000000000ULL) - 4503599627370496.0;
+  const double exponent = biasedExponent - (upperHalf ? 1022.0 : 1023.0);
+
+  const double s = (mantissa - 1.0) / (mantissa + 1.0);
+  const double s2 = s * s;
+  double p = 1.0 / 17.0;
+  p = p * s2 + 1.0 / 15.0;
+  p = p * s2 + 1.0 / 13.0;
+  p = p * s2 + 1.0 / 11.0;
+  p = p * s2 + 1.0 / 9.0;
+  p = p * s2 + 1.0 / 7.0;
+  p = p * s2 + 1.0 / 5.0;
+  p = p * s2 + 1.0 / 3.0;
+  p = p * s2 + 1.0;
+  const double lnMantissa = 2.0 * s * p;
+  return exponent + lnMantissa * Detail::kInvLn2;
+}
+
+// base^exponent for base >= 0 (0^e is 0 for any e; callers only raise envelopes and ratios).
+constexpr double pow (double base, double exponent)
+{
+  const double result = exp2 (exponent * log2 (base));
+  return base <= 0.0 ? 0.0 : result;
+}
+
+// sin (x): reduce to [-pi, pi], fold to [-pi/2, pi/2] and evaluate the odd Taylor polynomial
+// up to x^15.
+constexpr double sin (double x)
+{
+  const double turns = Detail::roundToNearest (x * Detail::kInvTwoPi);
+  const double reduced = (x - turns * Detail::kTwoPiHigh) - turns * Detail::kTwoPiLow;
+  const double folded = reduced < -Detail::kHalfPi ? -Detail::kPi - reduced : reduced;
+  const double r = folded > Detail::kHalfPi ? Detail::kPi - folded : folded;
+
+  // Estrin's scheme keeps the dependency chain short; the voice loop is latency-bound.
+  const double r2 = r * r;
+  const double r4 = r2 * r2;
+  const double r8 = r4 * r4;
+  const double p01 = 1.0 - r2 * (1.0 / 6.0);
+  const double p23 = (1.0 / 120.0) - r2 * (1.0 / 5040.0);
+  const double p45 = (1.0 / 362880.0) - r2 * (1.0 / 39916800.0);
+  const double p67 = (1.0 / 6227020800.0) - r2 * (1.0 / 1307674368000.0);
+  const double p = (p01 + r4 * p23) + r8 * (p45 + r4 * p67);
+  return r * p;
+}
+
+// tanh (x) = (e^2x - 1) / (e^2x + 1) through exp2, with a short odd series near zero where the
+// quotient would cancel. Both are evaluated and one selected; from |x| = 20 on the quotient
+// rounds to exactly 1.
+constexpr double tanh (double x)
+{
+  const double magnitude = x < 0.0 ? -x : x;
+  const double x2 = x * x;
+  double series = 62.0 / 2835.0;
+  series = series * x2 - 17.0 / 315.0;
+  series = series * x2 + 2.0 / 15.0;
+  series = series * x2 - 1.0 / 3.0;
+  series = x + x * x2 * series;
+
+  const double e = exp2 (2.0 * std::min (magnitude, 20.0) * Detail::kInvLn2);
+  const double quotient = (e - 1.0) / (e + 1.0);
+  const double result = x < 0.0 ? -quotient : quotient;
+  return magnitude < 0.0625 ? series : result;
+}
+
+} // namespace Steinberg::WestCoastDrumSynth::FastMath
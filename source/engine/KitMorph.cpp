@@ -0,0 +1,58 @@
+#include "engine/KitMorph.h"
+
+namespace Steinberg::WestCoastDrumSynth {
+
+namespace {
+
+constexpr std::array<double LaneFrame::*, kLaneFrameFieldCount> kLaneFrameFields {
+  &LaneFrame::frequencyHz, &LaneFrame::decaySeconds, &LaneFrame::oscLevel, &LaneFrame::foldAmount,
+  &LaneFrame::fmAmount, &LaneFrame::bodyFilterCutoffHz, &LaneFrame::bodyFilterResonance,
+  &LaneFrame::bodyFilterEnvAmount, &LaneFrame::outputLevel, &LaneFrame::noiseLevel, &LaneFrame::noiseAmount,
+  &LaneFrame::noiseFilterCutoffHz, &LaneFrame::pitchEnvAmount, &LaneFrame::pitchEnvDecaySeconds,
+  &LaneFrame::transientLevel, &LaneFrame::transientAmount, &LaneFrame::transientDecaySeconds,
+  &LaneFrame::transientMix, &LaneFrame::noiseTone, &LaneFrame::noiseDecaySeconds, &LaneFrame::noiseResonance,
+  &LaneFrame::noiseEnvAmount, &LaneFrame::snapAmount, &LaneFrame::driveAmount, &LaneFrame::level,
+  &LaneFrame::pan, &LaneFrame::oscFilterCutoff, &LaneFrame::oscFilterResonance,
+  &LaneFrame::oscFilterEnvAmount, &LaneFrame::transFilterCutoff, &LaneFrame::transFilterResonance,
+  &LaneFrame::transFilterEnvAmount,
+};
+
+// A field added to LaneFrame without a kLaneFrameFields entry would silently not morph.
+static_assert (sizeof (LaneFrame) == sizeof (double) * (kLaneFrameFieldCount + 1));
+
+} // namespace
+
+void packLaneFrames (const std::array<LaneFrame, kLaneCount>& frames, LaneFrameBank& bank)
+{
+  for (int32 field = 0; field < kLaneFrameFieldCount; ++field)
+  {
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+      bank.fields[field][lane] = frames[lane].*kLaneFrameFields[field];
+  }
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+    bank.characters[lane] = frames[lane].character;
+}
+
+void blendLaneFrames (const LaneFrameBank& a, const LaneFrameBank& b, double position,
+                      std::array<LaneFrame, kLaneCount>& frames)
+{
+  LaneFrameBank blended;
+  for (int32 field = 0; field < kLaneFrameFieldCount; ++field)
+  {
+    const auto& from = a.fields[field];
+    const auto& to = b.fields[field];
+    auto& out = blended.fields[field];
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+      out[lane] = from[lane] + (position * (to[lane] - from[lane]));
+  }
+
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    LaneFrame& frame = frames[lane];
+    frame.character = position < 0.5 ? a.characters[lane] : b.characters[lane];
+    for (int32 field = 0; field < kLaneFrameFieldCount; ++field)
+      frame.*kLaneFrameFields[field] = blended.fields[field][lane];
+  }
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
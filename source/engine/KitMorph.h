@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ParameterIds.h"
+#include "engine/LaneFrame.h"
+
+#include <array>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+// Numeric LaneFrame fields, i.e. everything but character.
+constexpr int32 kLaneFrameFieldCount = 32;
+
+// A kit of lane frames stored field-major: fields[f][lane] holds field f of every lane, so a blend
+// runs one contiguous kLaneCount-wide multiply-add per field.
+struct LaneFrameBank {
+  alignas (64) std::array<std::array<double, kLaneCount>, kLaneFrameFieldCount> fields {};
+  std::array<LaneCharacter, kLaneCount> characters {};
+};
+
+void packLaneFrames (const std::array<LaneFrame, kLaneCount>& frames, LaneFrameBank& bank);
+
+// frames = a + position * (b - a) for every numeric field; position 0 gives a's values exactly.
+// Each lane keeps a's character below position 0.5 and takes b's from there on.
+void blendLaneFrames (const LaneFrameBank& a, const LaneFrameBank& b, double position,
+                      std::array<LaneFrame, kLaneCount>& frames);
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+enum class LaneCharacter : uint8_t {
+  Kick = 0,
+  Snare,
+  Hat,
+  PercA,   // Low bass groove (lanes 3, 4)
+  PercB,   // Higher percussion (lanes 5, 6)
+  RimShot,
+  Clap
+};
+
+struct LaneFrame {
+  LaneCharacter character {LaneCharacter::Kick};
+  double frequencyHz {120.0};
+  double decaySeconds {0.25};
+  double oscLevel {0.9};
+  double foldAmount {0.3};
+  double fmAmount {0.2};
+  double bodyFilterCutoffHz {2600.0};
+  double bodyFilterResonance {0.3};
+  double bodyFilterEnvAmount {0.8};
+  double outputLevel {0.7};
+
+  double noiseLevel {0.15};
+  double noiseAmount {0.15};
+  double noiseFilterCutoffHz {6200.0};
+  double pitchEnvAmount {0.25};
+  double pitchEnvDecaySeconds {0.06};
+
+  double transientLevel {0.45};
+  double transientAmount {0.2};
+  double transientDecaySeconds {0.03};
+  double transientMix {0.42};
+  double noiseTone {0.0};
+  double noiseDecaySeconds {0.12};
+  double noiseResonance {0.45};
+  double noiseEnvAmount {0.55};
+  double snapAmount {0.2};
+  double driveAmount {0.1};
+  double level {0.7};
+  double pan {0.0};
+
+  double oscFilterCutoff {0.65};
+  double oscFilterResonance {0.08};
+  double oscFilterEnvAmount {0.35};
+  double transFilterCutoff {0.70};
+  double transFilterResonance {0.05};
+  double transFilterEnvAmount {0.40};
+
+  bool operator== (const LaneFrame&) const = default;
+};
+
+} // namespace Steinberg::WestCoastDrumSynth
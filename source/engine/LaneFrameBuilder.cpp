@@ -0,0 +1,229 @@
+#include "engine/LaneFrameBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+namespace {
+
+inline double clamp01 (double x)
+{
+  return std::clamp (x, 0.0, 1.0);
+}
+
+inline double responseCurve (double x, double exponent)
+{
+  return std::pow (clamp01 (x), exponent);
+}
+
+inline double responseRange (double x, double minimum, double maximum, double exponent)
+{
+  return minimum + (responseCurve (x, exponent) * (maximum - minimum));
+}
+
+// 1 for the dense slots of one lane block that follow the morph slider, 0 for drive, level, pan,
+// LED, mute and the unused tail of the block.
+constexpr std::array<double, kLaneDenseStride> makeLaneMorphMask ()
+{
+  std::array<double, kLaneDenseStride> mask {};
+  for (const auto id : allParameterIds ())
+  {
+    if (laneFromParamID (id) != 0 && laneFromExtraParamID (id) != 0 && laneFromMacroParamID (id) != 0 &&
+        laneFromFilterParamID (id) != 0 && id != laneOscMixParamID (0))
+      continue;
+    const int32 offset = laneOffsetFromParamID (id);
+    if (offset == kLaneDrive || offset == kLaneLevel || offset == kLanePan)
+      continue;
+    mask[denseParamIndex (id) - laneDenseIndex (0, 0)] = 1.0;
+  }
+  return mask;
+}
+
+constexpr std::array<double, kLaneDenseStride> kLaneMorphMask = makeLaneMorphMask ();
+
+// Per-lane scaling of the global osc filter onto each lane's body filter.
+constexpr std::array<double, kLaneCount> kOscCutoffScale {
+  0.62, 0.88, 1.70, 1.08, 1.06, 1.12, 1.18, 1.15};
+constexpr std::array<double, kLaneCount> kOscResScale {
+  1.08, 1.0, 0.82, 0.96, 0.98, 1.00, 1.08, 1.05};
+constexpr std::array<double, kLaneCount> kOscEnvScale {
+  1.24, 1.02, 0.58, 0.92, 0.90, 0.88, 0.78, 0.82};
+
+} // namespace
+
+void morphParameters (const ParameterImage& params, uint32 laneMask, ParameterImage& morphed)
+{
+  // Globals never morph; lane blocks share one mask, so x + offset * mask is x itself outside it.
+  std::copy_n (params.begin (), kGlobalDenseSlots, morphed.begin ());
+  const double morphOffset = params[denseParamIndex (kParamRandomizeAmount)] - 0.5;
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    if ((laneMask & (1u << lane)) == 0)
+      continue;
+    const int32 base = laneDenseIndex (lane, 0);
+    for (int32 i = 0; i < kLaneDenseStride; ++i)
+      morphed[base + i] = clamp01 (params[base + i] + (morphOffset * kLaneMorphMask[i]));
+  }
+}
+
+void buildLaneFrames (const ParameterImage& params, uint32 laneMask, std::array<LaneFrame, kLaneCount>& frames)
+{
+  ParameterImage morphed {};
+  morphParameters (params, laneMask, morphed);
+  buildLaneFramesFromMorphed (morphed, laneMask, frames);
+}
+
+void buildLaneFramesFromMorphed (const ParameterImage& morphed, uint32 laneMask,
+                                 std::array<LaneFrame, kLaneCount>& frames)
+{
+  if (laneMask == 0)
+    return;
+
+  const auto valueOf = [&morphed] (Vst::ParamID id) { return morphed[denseParamIndex (id)]; };
+
+  // Tuning workflow: adjust per-lane scale tables below (kTransient*Scale, kOsc*, kNoise*, etc.),
+  // then lane defaults in kLaneExtraDefaults / kLaneMacroDefaults / kLaneFilterDefaults (state/StateMigration.h).
+  // FactoryPresets.cpp controls preset snapshots; morphParameters () applies the morph (center = stored value).
+
+  // Kick, Snare, Hat, PercA1, PercA2 (low bass), PercB1, Clap, RimShot
+  static constexpr std::array<double, kLaneCount> kBaseFrequencies {
+    52.0, 185.0, 3800.0, 45.0, 65.0, 520.0, 650.0, 950.0};
+  static constexpr std::array<LaneCharacter, kLaneCount> kLaneCharacters {
+    LaneCharacter::Kick, LaneCharacter::Snare, LaneCharacter::Hat,
+    LaneCharacter::PercA, LaneCharacter::PercA, LaneCharacter::PercB,
+    LaneCharacter::Clap, LaneCharacter::RimShot};
+  static constexpr std::array<double, kLaneCount> kPitchEnvScale {
+    1.0, 0.60, 0.28, 0.85, 0.82, 0.72, 0.48, 0.58};
+  static constexpr std::array<double, kLaneCount> kTransientAttackScale {
+    1.0, 0.92, 0.74, 0.90, 0.88, 0.92, 0.88, 0.95};
+  static constexpr std::array<double, kLaneCount> kTransientDecayScale {
+    1.4, 1.16, 0.68, 1.3, 1.25, 0.94, 0.78, 0.85};
+  static constexpr std::array<double, kLaneCount> kTransientLevelScale {
+    1.35, 1.10, 0.88, 1.25, 1.20, 1.02, 1.12, 1.08};
+  static constexpr std::array<double, kLaneCount> kNoiseLevelScale {
+    1.05, 2.05, 1.65, 1.35, 1.38, 1.42, 1.75, 1.55};
+  static constexpr std::array<double, kLaneCount> kNoiseDecayScale {
+    0.82, 1.58, 0.94, 1.15, 1.12, 1.08, 0.88, 0.95};
+  static constexpr std::array<double, kLaneCount> kNoiseResScale {
+    0.90, 1.04, 1.12, 0.98, 1.00, 1.02, 1.12, 1.08};
+  static constexpr std::array<double, kLaneCount> kNoiseEnvScale {
+    0.88, 1.02, 1.18, 0.98, 1.00, 1.05, 1.18, 1.12};
+  static constexpr std::array<double, kLaneCount> kSnapScale {
+    0.24, 1.0, 0.86, 0.55, 0.52, 0.62, 0.68, 0.75};
+  static constexpr std::array<double, kLaneCount> kOscBalance {
+    1.0, 0.92, 0.76, 0.94, 0.92, 0.90, 0.82, 0.86};
+  // Keep enough travel for sound design, but narrow the most extreme tuning
+  // swings so small moves land on more usable drum fundamentals.
+  static constexpr std::array<double, kLaneCount> kPitchSemitoneRange {
+    30.0, 24.0, 18.0, 28.0, 26.0, 22.0, 14.0, 16.0};
+  static constexpr std::array<bool, kLaneCount> kLaneIsLowRegister {
+    true, true, false, true, true, false, false, false};
+
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    if ((laneMask & (1u << lane)) == 0)
+      continue;
+
+    LaneFrame frame {};
+    frame.character = kLaneCharacters[lane];
+
+    const double tune = valueOf (laneParamID (lane, kLaneTune));
+    const double semitoneRange = kPitchSemitoneRange[lane];
+    const double semitones = (tune * 2.0 - 1.0) * semitoneRange;
+    frame.frequencyHz = kBaseFrequencies[lane] * std::pow (2.0, semitones / 12.0);
+    frame.frequencyHz = std::clamp (frame.frequencyHz, 8.0, 20000.0);
+
+    const double decay = valueOf (laneParamID (lane, kLaneDecay));
+    frame.decaySeconds = 0.02 + (decay * decay * 1.95);
+    const double level = valueOf (laneParamID (lane, kLaneLevel));
+    frame.outputLevel = std::pow (level, 1.05);
+    frame.oscLevel = std::clamp ((0.40 + (std::pow (level, 0.80) * 1.25)) * kOscBalance[lane], 0.0, 2.0);
+    const double oscMix = valueOf (laneOscMixParamID (lane));
+    frame.oscLevel *= oscMix;
+
+    const double foldRaw = valueOf (laneParamID (lane, kLaneFold));
+    const double fmRaw = valueOf (laneParamID (lane, kLaneFm));
+    const double foldMin = kLaneIsLowRegister[lane] ? 0.0 : 0.18;
+    const double foldMax = kLaneIsLowRegister[lane] ? 0.42 : 0.82;
+    const double fmMin = kLaneIsLowRegister[lane] ? 0.0 : 0.15;
+    const double fmMax = kLaneIsLowRegister[lane] ? 0.38 : 0.78;
+    frame.foldAmount = responseRange (foldRaw, foldMin, foldMax, 1.6);
+    frame.fmAmount = responseRange (fmRaw, fmMin, fmMax, 1.7);
+
+    const double noiseRaw = valueOf (laneParamID (lane, kLaneNoise));
+    const double noiseMin = kLaneIsLowRegister[lane] ? 0.0 : 0.12;
+    const double noiseMax = kLaneIsLowRegister[lane] ? 0.40 : 0.80;
+    const double noise = responseRange (noiseRaw, noiseMin, noiseMax, 1.55);
+    frame.noiseAmount = std::clamp (std::pow (noise, 1.10) * 1.10, 0.0, 2.5);
+    frame.noiseLevel = std::clamp (std::pow (noise, 1.18) * kNoiseLevelScale[lane], 0.0, 2.5);
+    frame.pitchEnvAmount = std::clamp (valueOf (laneExtraParamID (lane, kLanePitchEnvAmount)) *
+                                         kPitchEnvScale[lane],
+                                        0.0, 1.0);
+    const double pitchDecay = valueOf (laneExtraParamID (lane, kLanePitchEnvDecay));
+    frame.pitchEnvDecaySeconds = 0.006 + (pitchDecay * pitchDecay * 0.55);
+    frame.transientAmount = std::clamp (std::pow (valueOf (laneExtraParamID (lane, kLaneTransientAttack)), 1.10) *
+                                          kTransientAttackScale[lane],
+                                        0.0, 1.0);
+    const double transientDecay = valueOf (laneMacroParamID (lane, kLaneTransientDecay));
+    frame.transientDecaySeconds =
+      std::clamp ((0.003 + (transientDecay * transientDecay * 0.46)) * kTransientDecayScale[lane], 0.0015, 0.5);
+    const double transientLevel = valueOf (laneMacroParamID (lane, kLaneTransientMix));
+    // No minimum floor: at 0% the transient path is fully silent (was 0.18 bleed-through).
+    frame.transientLevel =
+      std::clamp (std::pow (transientLevel, 1.12) * 1.55 * kTransientLevelScale[lane], 0.0, 2.5);
+    frame.transientMix = std::clamp (transientLevel * 1.12, 0.0, 1.4);
+    const double noiseTone = valueOf (laneExtraParamID (lane, kLaneNoiseTone));
+    frame.noiseTone = (noiseTone * 2.0) - 1.0;
+    frame.noiseFilterCutoffHz = 220.0 + (std::pow (noiseTone, 1.40) * 16000.0);
+    const double noiseDecay = valueOf (laneExtraParamID (lane, kLaneNoiseDecay));
+    frame.noiseDecaySeconds = (0.008 + (noiseDecay * noiseDecay * 1.3));
+    frame.noiseResonance =
+      std::clamp ((0.05 + (valueOf (laneMacroParamID (lane, kLaneNoiseResonance)) * 0.90)) * kNoiseResScale[lane],
+                  0.0, 0.98);
+    frame.noiseEnvAmount =
+      std::clamp ((0.18 + (valueOf (laneMacroParamID (lane, kLaneNoiseEnvAmount)) * 1.25)) * kNoiseEnvScale[lane],
+                  0.0, 1.5);
+    frame.snapAmount = std::clamp (valueOf (laneExtraParamID (lane, kLaneSnap)) * kSnapScale[lane], 0.0, 1.0);
+
+    const double driveRaw = valueOf (laneParamID (lane, kLaneDrive));
+    const double driveMin = kLaneIsLowRegister[lane] ? 0.0 : 0.12;
+    const double driveMax = kLaneIsLowRegister[lane] ? 0.36 : 0.70;
+    frame.driveAmount = responseRange (driveRaw, driveMin, driveMax, 1.75);
+    frame.level = frame.outputLevel;
+    frame.pan = (valueOf (laneParamID (lane, kLanePan)) * 2.0) - 1.0;
+
+    frame.oscFilterCutoff = valueOf (laneFilterParamID (lane, kLaneOscFilterCutoff));
+    frame.oscFilterResonance = std::clamp (valueOf (laneFilterParamID (lane, kLaneOscFilterRes)), 0.0, 1.0);
+    frame.oscFilterEnvAmount = valueOf (laneFilterParamID (lane, kLaneOscFilterEnv));
+    frame.transFilterCutoff = valueOf (laneFilterParamID (lane, kLaneTransFilterCutoff));
+    frame.transFilterResonance = std::clamp (valueOf (laneFilterParamID (lane, kLaneTransFilterRes)), 0.0, 1.0);
+    frame.transFilterEnvAmount = valueOf (laneFilterParamID (lane, kLaneTransFilterEnv));
+
+    frames[lane] = frame;
+  }
+
+  applyGlobalOscFilter (morphed, laneMask, frames);
+}
+
+void applyGlobalOscFilter (const ParameterImage& params, uint32 laneMask, std::array<LaneFrame, kLaneCount>& frames)
+{
+  const auto valueOf = [&params] (Vst::ParamID id) { return params[denseParamIndex (id)]; };
+  const double globalOscCutoffHz = 90.0 + (std::pow (valueOf (kParamOscFilterCutoff), 1.80) * 15000.0);
+  const double globalOscResonance = 0.04 + (valueOf (kParamOscFilterResonance) * 0.88);
+  const double globalOscEnv = 0.10 + (valueOf (kParamOscFilterEnv) * 2.1);
+
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    if ((laneMask & (1u << lane)) == 0)
+      continue;
+
+    LaneFrame& frame = frames[lane];
+    frame.bodyFilterCutoffHz = std::clamp (globalOscCutoffHz * kOscCutoffScale[lane], 80.0, 18000.0);
+    frame.bodyFilterResonance =
+      std::clamp ((globalOscResonance + (frame.foldAmount * 0.12)) * kOscResScale[lane], 0.0, 0.98);
+    frame.bodyFilterEnvAmount = std::clamp (globalOscEnv * kOscEnvScale[lane], 0.0, 2.5);
+  }
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "ParameterIds.h"
+#include "engine/LaneFrame.h"
+
+#include <array>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+// Writes the globals and the lane blocks in laneMask of params, shifted by the morph slider, to
+// morphed: every sound parameter except drive, level and pan moves by the slider's offset from
+// centre, clamped to [0, 1]; everything else is copied. One branch-free pass per block.
+void morphParameters (const ParameterImage& params, uint32 laneMask, ParameterImage& morphed);
+
+// Derives frames[lane] for every lane set in laneMask from a morphParameters () result whose
+// globals and laneMask blocks are current.
+void buildLaneFramesFromMorphed (const ParameterImage& morphed, uint32 laneMask,
+                                 std::array<LaneFrame, kLaneCount>& frames);
+
+// Recomputes the body filter of frames[lane] for every lane in laneMask, the only fields the global
+// osc filter parameters feed, from the globals of params (which never morph) and the frame's fold.
+// buildLaneFramesFromMorphed () ends with it; alone it retunes frames built with other globals.
+void applyGlobalOscFilter (const ParameterImage& params, uint32 laneMask, std::array<LaneFrame, kLaneCount>& frames);
+
+// morphParameters () into a local image, then buildLaneFramesFromMorphed (). Pure function of
+// params, so preset banks can be built ahead of time with the same mapping the processor uses.
+void buildLaneFrames (const ParameterImage& params, uint32 laneMask, std::array<LaneFrame, kLaneCount>& frames);
+
+} // namespace Steinberg::WestCoastDrumSynth
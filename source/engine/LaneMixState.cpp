@@ -0,0 +1,130 @@
+#include "engine/LaneMixState.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+void LaneMixState::setSampleRate (double sampleRate)
+{
+  glideLength_ = std::max (1, static_cast<int32> (std::lround (sampleRate * kGlideSeconds)));
+}
+
+void LaneMixState::reset ()
+{
+  glideRemaining_ = 0;
+  snapNextUpdate_ = true;
+}
+
+void LaneMixState::update (const std::array<LaneFrame, kLaneCount>& frames, uint32 mutedMask)
+{
+  activeMask_ = 0;
+  activeCount_ = 0;
+  bool gainsChanged = false;
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    const uint32 bit = 1u << lane;
+    if ((mutedMask & bit) == 0 && frames[lane].outputLevel > 1e-6)
+    {
+      activeMask_ |= bit;
+      activeLanes_[activeCount_++] = lane;
+    }
+
+    const double pan = std::clamp (frames[lane].pan, -1.0, 1.0);
+    const double targetL = std::sqrt (0.5 * (1.0 - pan));
+    const double targetR = std::sqrt (0.5 * (1.0 + pan));
+    gainsChanged = gainsChanged || targetL != targetL_[lane] || targetR != targetR_[lane];
+    targetL_[lane] = targetL;
+    targetR_[lane] = targetR;
+  }
+
+  if (snapNextUpdate_)
+  {
+    gainL_ = targetL_;
+    gainR_ = targetR_;
+    glideRemaining_ = 0;
+    snapNextUpdate_ = false;
+    return;
+  }
+  if (!gainsChanged)
+    return;
+
+  // Restart the glide from wherever the gains are now.
+  const double invLength = 1.0 / static_cast<double> (glideLength_);
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    stepL_[lane] = (targetL_[lane] - gainL_[lane]) * invLength;
+    stepR_[lane] = (targetR_[lane] - gainR_[lane]) * invLength;
+  }
+  glideRemaining_ = glideLength_;
+}
+
+uint32 LaneMixState::activeMask () const
+{
+  return activeMask_;
+}
+
+bool LaneMixState::isActive (int32 lane) const
+{
+  return (activeMask_ & (1u << lane)) != 0;
+}
+
+template <typename Sample>
+void LaneMixState::mix (const LaneArray<Sample>* block, int32 numSamples, Sample* left, Sample* right)
+{
+  int32 i = 0;
+  for (; i < numSamples && glideRemaining_ > 0; ++i)
+  {
+    Sample sumL = 0;
+    Sample sumR = 0;
+    for (int32 n = 0; n < activeCount_; ++n)
+    {
+      const int32 lane = activeLanes_[n];
+      sumL += block[i][lane] * static_cast<Sample> (gainL_[lane]);
+      sumR += block[i][lane] * static_cast<Sample> (gainR_[lane]);
+    }
+    left[i] = sumL;
+    right[i] = sumR;
+
+    // Every lane glides, muted ones included, so an unmute lands on the current pan.
+    if (--glideRemaining_ == 0)
+    {
+      gainL_ = targetL_;
+      gainR_ = targetR_;
+    }
+    else
+    {
+      for (int32 lane = 0; lane < kLaneCount; ++lane)
+      {
+        gainL_[lane] += stepL_[lane];
+        gainR_[lane] += stepR_[lane];
+      }
+    }
+  }
+
+  mixConstant (block + i, numSamples - i, left + i, right + i);
+}
+
+template <typename Sample>
+void LaneMixState::mixConstant (const LaneArray<Sample>* block, int32 numSamples, Sample* left,
+                                Sample* right) const
+{
+  for (int32 i = 0; i < numSamples; ++i)
+  {
+    Sample sumL = 0;
+    Sample sumR = 0;
+    for (int32 n = 0; n < activeCount_; ++n)
+    {
+      const int32 lane = activeLanes_[n];
+      sumL += block[i][lane] * static_cast<Sample> (gainL_[lane]);
+      sumR += block[i][lane] * static_cast<Sample> (gainR_[lane]);
+    }
+    left[i] = sumL;
+    right[i] = sumR;
+  }
+}
+
+template void LaneMixState::mix<double> (const LaneArray<double>*, int32, double*, double*);
+template void LaneMixState::mix<float> (const LaneArray<float>*, int32, float*, float*);
+
+} // namespace Steinberg::WestCoastDrumSynth
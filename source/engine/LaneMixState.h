@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ParameterIds.h"
+#include "engine/DrumVoiceBank.h"
+#include "engine/LaneFrame.h"
+
+#include <array>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+// Per-lane mixer state derived from the parameters: which lanes render (not muted and above the
+// level gate) and their constant-power pan gains. Rebuilt only when parameters change; a pan
+// change glides to the new gains over kGlideSeconds instead of stepping.
+class LaneMixState {
+public:
+  static constexpr double kGlideSeconds = 0.01;
+
+  void setSampleRate (double sampleRate);
+  // The next update () jumps straight to its gains instead of gliding.
+  void reset ();
+  void update (const std::array<LaneFrame, kLaneCount>& frames, uint32 mutedMask);
+
+  uint32 activeMask () const;
+  bool isActive (int32 lane) const;
+
+  // Pan-sums the active lanes of block into left/right, advancing any running glide. Instantiated
+  // for the float and double voice banks; the gains themselves are always kept in double.
+  template <typename Sample>
+  void mix (const LaneArray<Sample>* block, int32 numSamples, Sample* left, Sample* right);
+
+private:
+  template <typename Sample>
+  void mixConstant (const LaneArray<Sample>* block, int32 numSamples, Sample* left, Sample* right) const;
+
+  int32 glideLength_ {441};
+  int32 glideRemaining_ {0};
+  bool snapNextUpdate_ {true};
+
+  uint32 activeMask_ {0};
+  // Active lanes in ascending order, so the mix sums in the same order as a masked lane loop.
+  std::array<int32, kLaneCount> activeLanes_ {};
+  int32 activeCount_ {0};
+
+  LaneSamples gainL_ {};
+  LaneSamples gainR_ {};
+  LaneSamples targetL_ {};
+  LaneSamples targetR_ {};
+  LaneSamples stepL_ {};
+  LaneSamples stepR_ {};
+};
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "ParameterIds.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+// Factors a lane's nonlinear core (the wavefold and the drive clipper) can run at: 1x, 2x, 4x.
+constexpr int32 kOversamplingChoiceCount = 3;
+constexpr int32 kMaxOversampling = 4;
+
+inline int32 oversamplingFromNormalized (double normalized)
+{
+  const auto choice = static_cast<int32> ((std::clamp (normalized, 0.0, 1.0) * (kOversamplingChoiceCount - 1)) + 0.5);
+  return 1 << choice;
+}
+
+// Unique taps of the half-band stages, nearest the centre first (the centre tap is 1/2 and every
+// other tap is zero). Kaiser-windowed sincs normalised to unity DC gain: the 2x stage keeps
+// 0-18 kHz at 48 kHz within 0.01 dB and rejects its images by 60 dB, the 4x stage by 68 dB.
+inline constexpr std::array<double, 8> kHalfBandTaps2x {
+  0.3145732645610923,     -0.095384376190922895, 0.047129628889701236,   -0.024822762835922715,
+  0.012482682114767961,   -0.0055569130206026699, 0.0019571292905751544, -0.0003786528086883062,
+};
+inline constexpr std::array<double, 4> kHalfBandTaps4x {
+  0.29838036270271823, -0.058037745192746452, 0.0099817773580192851, -0.00032439486799110768,
+};
+
+// Delay of one upsample / downsample round trip at factor, in base-rate samples. The 4x stage's
+// own round trip is an odd number of 2x samples; one extra 2x sample keeps the total whole.
+constexpr int32 oversamplingLatency (int32 factor)
+{
+  constexpr int32 kStage2x = (2 * static_cast<int32> (kHalfBandTaps2x.size ())) - 1;
+  constexpr int32 kStage4x = static_cast<int32> (kHalfBandTaps4x.size ());
+  return factor >= 4 ? kStage2x + kStage4x : (factor == 2 ? kStage2x : 0);
+}
+
+// Latency of a voice bank whose lanes run at factors: each lane goes through the fold's and the
+// clipper's round trip, and every lane is padded to the slowest one.
+template <size_t Lanes>
+constexpr int32 bankOversamplingLatency (const std::array<int32, Lanes>& factors)
+{
+  int32 latency = 0;
+  for (const int32 factor : factors)
+    latency = std::max (latency, 2 * oversamplingLatency (factor));
+  return latency;
+}
+
+// The last N pushed samples, newest first, readable as one contiguous run.
+template <typename Sample, int32 N>
+class SampleHistory {
+public:
+  void push (Sample x)
+  {
+    head_ = (head_ == 0 ? N : head_) - 1;
+    data_[head_] = x;
+    data_[head_ + N] = x;
+  }
+
+  const Sample* newestFirst () const { return data_.data () + head_; }
+
+  void reset ()
+  {
+    data_.fill (Sample (0));
+    head_ = 0;
+  }
+
+private:
+  std::array<Sample, 2 * N> data_ {};
+  int32 head_ {0};
+};
+
+// One half-band FIR stage between a rate and twice that rate, in polyphase form: per low-rate
+// sample each direction is a symmetric 2 K-tap filter on one phase and a plain delay on the other.
+template <typename Sample, const auto& Taps>
+class HalfBandStage {
+public:
+  static constexpr int32 K = static_cast<int32> (Taps.size ());
+
+  // Writes the two high-rate samples for x.
+  void upsample (Sample x, Sample* out)
+  {
+    upHistory_.push (x);
+    const Sample* h = upHistory_.newestFirst ();
+    Sample sum = 0;
+    for (int32 k = 0; k < K; ++k)
+      sum += static_cast<Sample> (Taps[k]) * (h[K - 1 - k] + h[K + k]);
+    out[0] = Sample (2) * sum;
+    out[1] = h[K - 1];
+  }
+
+  // Band-limits the high-rate pair (first, second) and returns the low-rate sample.
+  Sample downsample (Sample first, Sample second)
+  {
+    evenHistory_.push (first);
+    oddHistory_.push (second);
+    const Sample* h = evenHistory_.newestFirst ();
+    Sample sum = 0;
+    for (int32 k = 0; k < K; ++k)
+      sum += static_cast<Sample> (Taps[k]) * (h[K - 1 - k] + h[K + k]);
+    return sum + (Sample (0.5) * oddHistory_.newestFirst ()[K]);
+  }
+
+  void reset ()
+  {
+    upHistory_.reset ();
+    evenHistory_.reset ();
+    oddHistory_.reset ();
+  }
+
+private:
+  SampleHistory<Sample, 2 * K> upHistory_ {};
+  SampleHistory<Sample, 2 * K> evenHistory_ {};
+  SampleHistory<Sample, K + 1> oddHistory_ {};
+};
+
+// Runs a memoryless (or sample-by-sample) shape at 2x or 4x inside a 1x signal path: upsample,
+// shape every high-rate sample, band-limit and decimate. Adds oversamplingLatency (factor).
+template <typename Sample>
+class HalfBandOversampler {
+public:
+  template <typename Shape>
+  Sample process (Sample x, int32 factor, Shape&& shape)
+  {
+    std::array<Sample, 2> low {};
+    stage2x_.upsample (x, low.data ());
+    if (factor < 4)
+      return stage2x_.downsample (shape (low[0]), shape (low[1]));
+
+    std::array<Sample, kMaxOversampling> high {};
+    stage4x_.upsample (low[0], high.data ());
+    stage4x_.upsample (low[1], high.data () + 2);
+    for (auto& sample : high)
+      sample = shape (sample);
+    const Sample first = stage4x_.downsample (high[0], high[1]);
+    const Sample second = stage4x_.downsample (high[2], high[3]);
+    const Sample delayed = pending_;
+    pending_ = second;
+    return stage2x_.downsample (delayed, first);
+  }
+
+  void reset ()
+  {
+    stage2x_.reset ();
+    stage4x_.reset ();
+    pending_ = 0;
+  }
+
+private:
+  HalfBandStage<Sample, kHalfBandTaps2x> stage2x_ {};
+  HalfBandStage<Sample, kHalfBandTaps4x> stage4x_ {};
+  Sample pending_ {0};
+};
+
+// Delay line with a per-call length, for lining signals up with an oversampled stage.
+template <typename Sample>
+class SampleDelay {
+public:
+  static constexpr int32 kCapacity = 64;
+
+  Sample process (Sample x, int32 delay)
+  {
+    data_[head_] = x;
+    const Sample y = data_[(head_ - delay) & (kCapacity - 1)];
+    head_ = (head_ + 1) & (kCapacity - 1);
+    return y;
+  }
+
+  void reset ()
+  {
+    data_.fill (Sample (0));
+    head_ = 0;
+  }
+
+private:
+  std::array<Sample, kCapacity> data_ {};
+  int32 head_ {0};
+};
+
+static_assert (2 * oversamplingLatency (kMaxOversampling) < SampleDelay<double>::kCapacity);
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,80 @@
+#include "engine/ParameterRandomizer.h"
+
+#include <algorithm>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+namespace {
+
+constexpr bool isRandomizedParam (Vst::ParamID id)
+{
+  if (id == kParamRandomize || id == kParamRandomizeAmount || id == kParamPresetSelect || id == kParamRun ||
+      id == kParamFollowTransport || id == kParamKitMorph || id == kParamKitMorphTarget ||
+      id == kParamQuality || isLaneLedParamID (id) || isLaneOversamplingParamID (id))
+    return false;
+  return id < kLaneMuteParamBase || id > kLaneMuteMaxParamId;
+}
+
+// Per dense slot: kRandomizeMaxDelta for randomized parameters, 0 for the rest and for the gaps
+// of the layout, so the randomize pass needs no per-slot branch.
+constexpr ParameterImage makeRandomizeDepths ()
+{
+  ParameterImage depths {};
+  for (const auto id : allParameterIds ())
+  {
+    if (isRandomizedParam (id))
+      depths[denseParamIndex (id)] = kRandomizeMaxDelta;
+  }
+  return depths;
+}
+
+constexpr std::array<int16, kRandomizedParamSlotCount> makeRandomizedParamSlots ()
+{
+  std::array<int16, kRandomizedParamSlotCount> slots {};
+  const ParameterImage depths = makeRandomizeDepths ();
+  int32 count = 0;
+  for (int32 slot = 0; slot < kDenseParameterCount; ++slot)
+  {
+    if (depths[slot] > 0.0)
+      slots[count++] = static_cast<int16> (slot);
+  }
+  return slots;
+}
+
+constexpr int32 countRandomizedParams ()
+{
+  int32 count = 0;
+  for (const auto id : allParameterIds ())
+    count += isRandomizedParam (id) ? 1 : 0;
+  return count;
+}
+
+static_assert (countRandomizedParams () == kRandomizedParamSlotCount);
+
+constexpr ParameterImage kRandomizeDepths = makeRandomizeDepths ();
+constexpr std::array<int16, kRandomizedParamSlotCount> kRandomizedParamSlots = makeRandomizedParamSlots ();
+
+// Top 53 bits of a draw as a double in [0, 1).
+constexpr double kUnitFromBits = 1.0 / 9007199254740992.0;
+
+} // namespace
+
+const std::array<int16, kRandomizedParamSlotCount>& getRandomizedParamSlots ()
+{
+  return kRandomizedParamSlots;
+}
+
+void randomizeParameters (ParameterImage& params, double amount, RandomizerState& state)
+{
+  // One key per press; slot draws are independent, so the loop carries no dependency.
+  const uint64 key = counterRandom (state.seed, state.generation);
+  for (int32 slot = 0; slot < kDenseParameterCount; ++slot)
+  {
+    const double unit = static_cast<double> (counterRandom (key, static_cast<uint64> (slot)) >> 11) * kUnitFromBits;
+    const double delta = ((unit * 2.0) - 1.0) * amount * kRandomizeDepths[slot];
+    params[slot] = std::clamp (params[slot] + delta, 0.0, 1.0);
+  }
+  ++state.generation;
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
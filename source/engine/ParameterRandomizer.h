@@ -0,0 +1,41 @@
+#pragma once
+
+#include "ParameterIds.h"
+
+#include <array>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+// Randomize state: every draw is a pure function of seed, generation and the parameter slot, so
+// the next Randomize after loading a saved state gives the same values as it would have in the
+// session that saved it. generation counts the Randomize presses since seed was chosen.
+struct RandomizerState {
+  uint64 seed {0};
+  uint64 generation {0};
+};
+
+// Largest change a Randomize can make to one parameter, at full morph amount.
+constexpr double kRandomizeMaxDelta = 0.35;
+
+// Dense slots Randomize changes: everything but transport, preset selection, the morph and kit
+// morph controls, the quality, the lane LEDs, mutes and oversampling factors. In ascending dense
+// store order.
+constexpr int32 kRandomizedParamSlotCount =
+  6 + (kLaneCount * (kLaneDenseFilterOffset + kLaneFilterParamCount + 1));
+
+const std::array<int16, kRandomizedParamSlotCount>& getRandomizedParamSlots ();
+
+// SplitMix64 finalizer of seed ^ counter; the generator keeps no state between draws.
+inline constexpr uint64 counterRandom (uint64 seed, uint64 counter)
+{
+  uint64 x = seed ^ (counter * 0x9E3779B97F4A7C15ull);
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+// Moves every randomized slot of params by up to amount * kRandomizeMaxDelta in one pass over the
+// image, then advances state.generation. Allocation- and lock-free; safe on the audio thread.
+void randomizeParameters (ParameterImage& params, double amount, RandomizerState& state);
+
+} // namespace Steinberg::WestCoastDrumSynth
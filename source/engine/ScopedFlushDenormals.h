@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define WCSD_DENORMALS_MXCSR 1
+#include <xmmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define WCSD_DENORMALS_FPCR 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#ifndef ARM64_FPCR
+#define ARM64_FPCR ARM64_SYSREG (3, 3, 4, 4, 0)
+#endif
+#endif
+#endif
+
+namespace Steinberg::WestCoastDrumSynth {
+
+// Flushes denormal results and operands to zero on the calling thread for the lifetime of the
+// object, then restores the previous mode. On x86 that is MXCSR FTZ | DAZ, on ARM64 FPCR.FZ (which
+// covers both); elsewhere it does nothing. Decaying filter and DC blocker states otherwise end up
+// in the denormal range, where x86 arithmetic slows down by an order of magnitude or more.
+class ScopedFlushDenormals {
+public:
+  ScopedFlushDenormals ()
+  {
+#if defined(WCSD_DENORMALS_MXCSR)
+    previous_ = _mm_getcsr ();
+    _mm_setcsr (static_cast<unsigned int> (previous_) | kMxcsrFlushToZero | kMxcsrDenormalsAreZero);
+#elif defined(WCSD_DENORMALS_FPCR)
+    previous_ = readFpcr ();
+    writeFpcr (previous_ | kFpcrFlushToZero);
+#endif
+  }
+
+  ~ScopedFlushDenormals ()
+  {
+#if defined(WCSD_DENORMALS_MXCSR)
+    _mm_setcsr (static_cast<unsigned int> (previous_));
+#elif defined(WCSD_DENORMALS_FPCR)
+    writeFpcr (previous_);
+#endif
+  }
+
+  ScopedFlushDenormals (const ScopedFlushDenormals&) = delete;
+  ScopedFlushDenormals& operator= (const ScopedFlushDenormals&) = delete;
+
+private:
+#if defined(WCSD_DENORMALS_MXCSR)
+  static constexpr unsigned int kMxcsrFlushToZero = 0x8000;
+  static constexpr unsigned int kMxcsrDenormalsAreZero = 0x0040;
+#elif defined(WCSD_DENORMALS_FPCR)
+  static constexpr uint64_t kFpcrFlushToZero = uint64_t {1} << 24;
+
+  static uint64_t readFpcr ()
+  {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<uint64_t> (_ReadStatusReg (ARM64_FPCR));
+#else
+    uint64_t value = 0;
+    __asm__ __volatile__ ("mrs %0, fpcr" : "=r"(value));
+    return value;
+#endif
+  }
+
+  static void writeFpcr (uint64_t value)
+  {
+#if defined(_MSC_VER) && !defined(__clang__)
+    _WriteStatusReg (ARM64_FPCR, static_cast<__int64> (value));
+#else
+    __asm__ __volatile__ ("msr fpcr, %0" : : "r"(value));
+#endif
+  }
+#endif
+
+  uint64_t previous_ {0};
+};
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -34,6 +34,11 @@ void StepSequencer::setRunning (bool running)
   running_ = running;
 }
 
+bool StepSequencer::isRunning () const
+{
+  return running_;
+}
+
 void StepSequencer::setPattern (const PatternGrid& pattern)
 {
   pattern_ = pattern;
@@ -60,24 +65,6 @@ void StepSequencer::syncToHost (double projectPpq, bool hostPlaying)
   samplesToNextStep_ = std::max (0.0, stepDur * (1.0 - frac));
 }
 
-void StepSequencer::processSample (std::array<bool, kLaneCount>& triggers)
-{
-  triggers.fill (false);
-  if (!running_)
-    return;
-
-  if (samplesToNextStep_ <= 0.0)
-  {
-    for (int32 lane = 0; lane < kLaneCount; ++lane)
-      triggers[lane] = pattern_[lane][currentStep_];
-
-    samplesToNextStep_ = stepDurationSamplesFor (currentStep_);
-    currentStep_ = (currentStep_ + 1) % kPatternSteps;
-  }
-
-  samplesToNextStep_ -= 1.0;
-}
-
 int32 StepSequencer::getCurrentStep () const
 {
   return currentStep_;
@@ -3,6 +3,7 @@
 #include "ParameterIds.h"
 
 #include <array>
+#include <cmath>
 
 namespace Steinberg::WestCoastDrumSynth {
 
@@ -12,13 +13,18 @@ public:
   void setTempo (double bpm);
   void setSwing (double swing);
   void setRunning (bool running);
+  bool isRunning () const;
   void setPattern (const PatternGrid& pattern);
   void reset ();
 
   // Keeps the sequencer phase hard-locked to host position.
   void syncToHost (double projectPpq, bool hostPlaying);
 
-  void processSample (std::array<bool, kLaneCount>& triggers);
+  // Advances the sequencer by numSamples and calls sink (sampleOffset, lane) for every lane hit
+  // in the block, in time order. Step boundaries are computed directly from the step lengths, so
+  // the cost is per step rather than per sample.
+  template <typename EventSink>
+  void collectTriggers (int32 numSamples, EventSink&& sink);
   int32 getCurrentStep () const;
 
 private:
@@ -31,7 +37,40 @@ private:
 
   PatternGrid pattern_ {};
   int32 currentStep_ {0};
+  // Samples left before the next step fires; a step fires on the first sample at which this is
+  // <= 0 and then lasts ceil (step duration) samples.
   double samplesToNextStep_ {0.0};
 };
 
+template <typename EventSink>
+void StepSequencer::collectTriggers (int32 numSamples, EventSink&& sink)
+{
+  if (!running_)
+    return;
+
+  int32 offset = 0;
+  double countdown = samplesToNextStep_;
+  for (;;)
+  {
+    const double remaining = static_cast<double> (numSamples - offset);
+    const double wait = countdown <= 0.0 ? 0.0 : std::ceil (countdown);
+    if (wait >= remaining)
+    {
+      samplesToNextStep_ = countdown - remaining;
+      return;
+    }
+
+    offset += static_cast<int32> (wait);
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+    {
+      if (pattern_[lane][currentStep_])
+        sink (offset, lane);
+    }
+
+    countdown = stepDurationSamplesFor (currentStep_) - 1.0;
+    currentStep_ = (currentStep_ + 1) % kPatternSteps;
+    ++offset;
+  }
+}
+
 } // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,650 @@
+#pragma once
+
+#include "engine/FastMath.h"
+#include "engine/LaneFrame.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Builds with WCSD_FAST_MATH=1 (CMake option of the same name) render voices through the
+// FastMath approximations instead of libm.
+#ifndef WCSD_FAST_MATH
+#define WCSD_FAST_MATH 1
+#endif
+
+// Samples between exact filter-coefficient evaluations at 48 kHz (CMake WCSD_CONTROL_INTERVAL).
+#ifndef WCSD_CONTROL_INTERVAL
+#define WCSD_CONTROL_INTERVAL 16
+#endif
+
+namespace Steinberg::WestCoastDrumSynth::VoiceDsp {
+
+// Shared building blocks of the drum voice: per-trigger coefficients, the nonlinearities, filters
+// and noise that DrumVoiceBank's lane kernel renders through.
+
+constexpr double kTwoPi = 6.28318530717958647692;
+constexpr double kPi = 3.14159265358979323846;
+constexpr size_t kCharacterCount = 7;
+
+// Indexed by LaneCharacter: Kick, Snare, Hat, PercA, PercB, RimShot, Clap
+constexpr std::array<double, kCharacterCount> kPitchSemitoneSpan {66.0, 20.0, 8.0, 36.0, 32.0, 18.0, 14.0};
+constexpr std::array<double, kCharacterCount> kTransientBaseHz {3200.0, 2500.0, 7000.0, 2200.0, 4500.0, 3500.0, 2200.0};
+constexpr std::array<double, kCharacterCount> kNoiseBlendGain {0.85, 1.25, 1.45, 1.10, 1.15, 1.30, 1.45};
+constexpr std::array<double, kCharacterCount> kBodyGain {1.05, 0.84, 0.42, 1.02, 0.96, 0.92, 0.88};
+constexpr std::array<double, kCharacterCount> kFmScale {1.0, 0.85, 0.40, 0.92, 0.88, 0.65, 0.45};
+constexpr std::array<double, kCharacterCount> kNoiseTransientBlend {0.62, 0.68, 0.38, 0.65, 0.58, 0.72, 0.55};
+constexpr std::array<double, kCharacterCount> kTransientGainBoost {1.65, 1.0, 1.0, 1.45, 1.35, 1.0, 1.0};
+
+// DC blocker (leaky integrator, ~5 Hz cutoff)
+constexpr double kDcCoef = 0.9995;
+
+constexpr bool kFastMath = WCSD_FAST_MATH != 0;
+
+// Transcendentals evaluated per sample by the render kernels. Per-trigger setup keeps libm.
+// T is the kernel's sample type (double or float); FastMath evaluates in double either way.
+template <typename T>
+inline T voiceSin (T x)
+{
+  if constexpr (kFastMath)
+    return static_cast<T> (FastMath::sin (x));
+  else
+    return std::sin (x);
+}
+
+template <typename T>
+inline T voiceExp2 (T x)
+{
+  if constexpr (kFastMath)
+    return static_cast<T> (FastMath::exp2 (x));
+  else
+    return std::pow (T (2), x);
+}
+
+template <typename T>
+inline T voicePow (T base, T exponent)
+{
+  if constexpr (kFastMath)
+    return static_cast<T> (FastMath::pow (base, exponent));
+  else
+    return std::pow (base, exponent);
+}
+
+template <typename T>
+inline T voiceTanh (T x)
+{
+  if constexpr (kFastMath)
+    return static_cast<T> (FastMath::tanh (x));
+  else
+    return std::tanh (x);
+}
+
+// Per-lane select through a bit mask rather than a branch. The lane loops of DrumVoiceBank commit
+// state with it: a ternary there is turned into branches that keep the loop from vectorizing.
+template <typename T>
+inline T selectLane (bool condition, T ifTrue, T ifFalse)
+{
+  using Bits = std::conditional_t<sizeof (T) == sizeof (uint64_t), uint64_t, uint32_t>;
+  static_assert (sizeof (T) == sizeof (Bits));
+  const Bits mask = Bits {0} - static_cast<Bits> (condition);
+  return std::bit_cast<T> ((std::bit_cast<Bits> (ifTrue) & mask) | (std::bit_cast<Bits> (ifFalse) & ~mask));
+}
+
+inline double clamp01 (double x)
+{
+  return std::clamp (x, 0.0, 1.0);
+}
+
+inline size_t characterIndex (LaneCharacter character)
+{
+  return std::min (static_cast<size_t> (character), kCharacterCount - 1);
+}
+
+constexpr double kSoftClipDrive = 1.42;
+
+template <typename T>
+inline T softClip (T x)
+{
+  return voiceTanh (x * T (kSoftClipDrive)) / static_cast<T> (std::tanh (kSoftClipDrive));
+}
+
+inline double cutoffFromNormalized (double normalized, double minHz, double maxHz)
+{
+  return minHz * std::pow (maxHz / minHz, normalized);
+}
+
+// Wavefolding: more dynamic range (1 + amount*16), 5 folds for richer harmonics
+template <typename T>
+inline T wavefoldGain (T amount)
+{
+  return T (1) + (amount * T (16));
+}
+
+// The fold at unit gain: a period-4 triangle, the identity on [-1, 1], up to the last of the five
+// reflections at |x| = kWavefoldReach; past it the output keeps falling with slope -1.
+constexpr double kWavefoldReach = 11.0;
+
+// Five reflections about +-1 in closed form, without data-dependent branches: x is reduced to its
+// offset from the nearest multiple of 4, which the triangle reflects once if it lies beyond +-1.
+// Every step is exact in float and double, so this returns the very values of the reflection
+// loop it replaces, infinities and NaN included. The clamp is written so that a NaN x lands on
+// its lower bound rather than reaching the integer cast, where it would be undefined; the NaN
+// still comes out through x - inner.
+template <typename T>
+inline T wavefold (T x)
+{
+  const T lower = x > T (-kWavefoldReach) ? x : T (-kWavefoldReach);
+  const T inner = lower < T (kWavefoldReach) ? lower : T (kWavefoldReach);
+  const T quarter = inner * T (0.25);
+  const auto whole = static_cast<int32_t> (quarter);
+  const T fraction = quarter - static_cast<T> (whole);
+  const int32_t nearest =
+    whole + static_cast<int32_t> (fraction > T (0.5)) - static_cast<int32_t> (fraction < T (-0.5));
+  const T offset = inner - (T (4) * static_cast<T> (nearest));
+  const T reflected = std::copysign (T (2), offset) - offset;
+  const T triangle = std::abs (offset) > T (1) ? reflected : offset;
+  return triangle - (x - inner);
+}
+
+// First-order antiderivative anti-aliasing (ADAA) of the two voice nonlinearities. Each output is
+// the nonlinearity averaged over the segment from the previous input to the current one,
+// (F (x) - F (previous)) / (x - previous) with F its antiderivative, which removes most of the
+// aliasing of the fold corners and the clipper for half a sample of delay. Always evaluated in
+// double: the difference quotient cancels most of the significant bits of F.
+constexpr double kAntiAliasMinDelta = 1e-5;
+constexpr double kLn2 = 0.69314718055994530942;
+
+inline double wavefoldAntiderivative (double x)
+{
+  const double inner = std::clamp (x, -kWavefoldReach, kWavefoldReach);
+  const double beyond = x - inner;
+  // Triangle phase w in [-2, 2): the triangle is 1 - |w|, its antiderivative w - w|w|/2 + 1/2.
+  const double shifted = inner + 1.0;
+  const double w = shifted - (4.0 * std::floor (shifted * 0.25)) - 2.0;
+  const double edge = 1.0 - std::abs (w);
+  return (w - (0.5 * w * std::abs (w)) + 0.5) + (edge * beyond) - (0.5 * beyond * beyond);
+}
+
+inline double softClipAntiderivative (double x)
+{
+  // log cosh, written so that it cannot overflow for large drive.
+  const double y = std::abs (x * kSoftClipDrive);
+  const double logCosh = y + std::log1p (std::exp (-2.0 * y)) - kLn2;
+  return logCosh / (kSoftClipDrive * std::tanh (kSoftClipDrive));
+}
+
+// x is the already scaled fold input (body * wavefoldGain ()); previous is the last one.
+template <typename T>
+inline T wavefoldAntiAliased (T x, double previous)
+{
+  const double input = x;
+  const double delta = input - previous;
+  const double averaged = wavefold (0.5 * (input + previous));
+  const double quotient = (wavefoldAntiderivative (input) - wavefoldAntiderivative (previous)) / delta;
+  return static_cast<T> (selectLane (std::abs (delta) < kAntiAliasMinDelta, averaged, quotient));
+}
+
+template <typename T>
+inline T softClipAntiAliased (T x, double previous)
+{
+  const double input = x;
+  const double delta = input - previous;
+  const double averaged = softClip (0.5 * (input + previous));
+  const double quotient = (softClipAntiderivative (input) - softClipAntiderivative (previous)) / delta;
+  return static_cast<T> (selectLane (std::abs (delta) < kAntiAliasMinDelta, averaged, quotient));
+}
+
+// Integration coefficient of the state-variable lowpass for a cutoff: 2 sin (pi fc / fs).
+inline double svfCoefficient (double cutoffHz, double sampleRate)
+{
+  const double maxCutoff = sampleRate * 0.43;
+  const double clippedCutoff = std::clamp (cutoffHz, 20.0, maxCutoff);
+  return std::clamp (2.0 * voiceSin (kPi * clippedCutoff / sampleRate), 0.0, 0.95);
+}
+
+inline double svfDamping (double resonance)
+{
+  return 1.0 - std::clamp (resonance, 0.0, 0.96);
+}
+
+template <typename T>
+inline T stateVariableLowpass (T input, T f, T damping, T& lowState, T& bandState)
+{
+  // Two-pass (2x oversampled) for stability at high cutoffs
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    const T high = input - lowState - (damping * bandState);
+    bandState += T (0.5) * f * high;
+    lowState += T (0.5) * f * bandState;
+  }
+
+  // Clamp filter states to prevent runaway
+  bandState = std::clamp (bandState, T (-8), T (8));
+  lowState = std::clamp (lowState, T (-8), T (8));
+
+  return lowState;
+}
+
+inline void advanceRandom (uint32_t& state)
+{
+  state ^= (state << 13);
+  state ^= (state >> 17);
+  state ^= (state << 5);
+}
+
+template <typename T = double>
+inline T randomBipolar (uint32_t& state)
+{
+  advanceRandom (state);
+  const T unit = static_cast<T> (state & 0x00FFFFFF) / static_cast<T> (0x00FFFFFF);
+  return (unit * T (2)) - T (1);
+}
+
+inline double wrapPhase (double phase)
+{
+  while (phase >= kTwoPi)
+    phase -= kTwoPi;
+  while (phase < 0.0)
+    phase += kTwoPi;
+  return phase;
+}
+
+// Clamps every frame field into the range the voice is designed for.
+inline LaneFrame sanitizeFrame (const LaneFrame& source)
+{
+  LaneFrame frame = source;
+  frame.frequencyHz = std::clamp (frame.frequencyHz, 8.0, 18000.0);
+  frame.oscLevel = std::clamp (frame.oscLevel, 0.0, 2.0);
+  frame.bodyFilterCutoffHz = std::clamp (frame.bodyFilterCutoffHz, 80.0, 18000.0);
+  frame.bodyFilterResonance = std::clamp (frame.bodyFilterResonance, 0.0, 0.98);
+  frame.bodyFilterEnvAmount = std::clamp (frame.bodyFilterEnvAmount, 0.0, 2.5);
+  frame.outputLevel = std::clamp (frame.outputLevel, 0.0, 1.5);
+  frame.noiseLevel = std::clamp (frame.noiseLevel, 0.0, 2.5);
+  frame.pitchEnvAmount = clamp01 (frame.pitchEnvAmount);
+  frame.noiseAmount = std::clamp (frame.noiseAmount, 0.0, 2.5);
+  frame.noiseFilterCutoffHz = std::clamp (frame.noiseFilterCutoffHz, 120.0, 18000.0);
+  frame.transientAmount = clamp01 (frame.transientAmount);
+  frame.transientLevel = std::clamp (frame.transientLevel, 0.0, 2.5);
+  frame.transientMix = std::clamp (frame.transientMix, 0.0, 1.4);
+  frame.snapAmount = clamp01 (frame.snapAmount);
+  frame.noiseTone = std::clamp (frame.noiseTone, -1.0, 1.0);
+  frame.noiseResonance = std::clamp (frame.noiseResonance, 0.0, 0.98);
+  frame.noiseEnvAmount = std::clamp (frame.noiseEnvAmount, 0.0, 1.5);
+  frame.level = std::clamp (frame.level, 0.0, 1.5);
+  frame.foldAmount = clamp01 (frame.foldAmount);
+  frame.fmAmount = clamp01 (frame.fmAmount);
+  frame.driveAmount = clamp01 (frame.driveAmount);
+  frame.decaySeconds = std::clamp (frame.decaySeconds, 0.01, 2.5);
+  frame.pitchEnvDecaySeconds = std::clamp (frame.pitchEnvDecaySeconds, 0.004, 0.8);
+  frame.noiseDecaySeconds = std::clamp (frame.noiseDecaySeconds, 0.004, 1.8);
+  frame.transientDecaySeconds = std::clamp (frame.transientDecaySeconds, 0.0015, 0.5);
+  frame.oscFilterCutoff = clamp01 (frame.oscFilterCutoff);
+  frame.oscFilterResonance = std::clamp (frame.oscFilterResonance, 0.0, 0.96);
+  frame.oscFilterEnvAmount = clamp01 (frame.oscFilterEnvAmount);
+  frame.transFilterCutoff = clamp01 (frame.transFilterCutoff);
+  frame.transFilterResonance = std::clamp (frame.transFilterResonance, 0.0, 0.96);
+  frame.transFilterEnvAmount = clamp01 (frame.transFilterEnvAmount);
+  return frame;
+}
+
+// Everything the render loop needs that only depends on the triggered frame and the sample rate.
+// T is double for one lane (computeCoefficients) and LaneArray<Sample> for the structure-of-arrays bank.
+template <typename T>
+struct VoiceCoefficientsT {
+  // Oscillator path
+  T frequencyHz {};
+  T pitchEnvAmount {};
+  T pitchSemitoneSpan {};
+  T fmAmount {};
+  T fmScale {};
+  T modFrequencyScale {};
+  T transientIncrement {};
+  T foldAmount {};
+  T oscBaseCutoff {};
+  T oscEnvModDepth {};
+  T oscCutoffMax {};
+  T oscDamping {};
+  T oscLevel {};
+  T bodyGain {};
+
+  // Transient path
+  T transientBlend {};
+  T transBaseCutoff {};
+  T transEnvModDepth {};
+  T transCutoffMax {};
+  T transDamping {};
+  T transientGain {};
+  T clickDepth {};
+
+  // Noise path
+  T snapAmount {};
+  T toneBlend {};
+  T snapExponent {};
+  T noiseCutoffBase {};
+  T noiseCutoffEnvDepth {};
+  T noiseDamping {};
+  T noiseAmount {};
+  T noiseLevel {};
+  T noiseBlendGain {};
+  T noiseLpCoef {};
+  T noiseHpCoef {};
+
+  // Output
+  T drive {};
+  T outputLevel {};
+
+  // Envelope decay per sample
+  T ampDecayCoef {};
+  T toneDecayCoef {};
+  T pitchDecayCoef {};
+  T noiseDecayCoef {};
+  T transientDecayCoef {};
+  T clickDecayCoef {};
+
+  // Envelope decay over one filter control interval (decay coef ^ interval)
+  T toneControlDecay {};
+  T transientControlDecay {};
+  T noiseControlDecay {};
+};
+
+using VoiceCoefficients = VoiceCoefficientsT<double>;
+
+// Calls fn (destinationField, sourceField) for every coefficient.
+template <typename Dest, typename Source, typename Fn>
+void forEachCoefficient (VoiceCoefficientsT<Dest>& dest, const VoiceCoefficientsT<Source>& source, Fn&& fn)
+{
+  fn (dest.frequencyHz, source.frequencyHz);
+  fn (dest.pitchEnvAmount, source.pitchEnvAmount);
+  fn (dest.pitchSemitoneSpan, source.pitchSemitoneSpan);
+  fn (dest.fmAmount, source.fmAmount);
+  fn (dest.fmScale, source.fmScale);
+  fn (dest.modFrequencyScale, source.modFrequencyScale);
+  fn (dest.transientIncrement, source.transientIncrement);
+  fn (dest.foldAmount, source.foldAmount);
+  fn (dest.oscBaseCutoff, source.oscBaseCutoff);
+  fn (dest.oscEnvModDepth, source.oscEnvModDepth);
+  fn (dest.oscCutoffMax, source.oscCutoffMax);
+  fn (dest.oscDamping, source.oscDamping);
+  fn (dest.oscLevel, source.oscLevel);
+  fn (dest.bodyGain, source.bodyGain);
+  fn (dest.transientBlend, source.transientBlend);
+  fn (dest.transBaseCutoff, source.transBaseCutoff);
+  fn (dest.transEnvModDepth, source.transEnvModDepth);
+  fn (dest.transCutoffMax, source.transCutoffMax);
+  fn (dest.transDamping, source.transDamping);
+  fn (dest.transientGain, source.transientGain);
+  fn (dest.clickDepth, source.clickDepth);
+  fn (dest.snapAmount, source.snapAmount);
+  fn (dest.toneBlend, source.toneBlend);
+  fn (dest.snapExponent, source.snapExponent);
+  fn (dest.noiseCutoffBase, source.noiseCutoffBase);
+  fn (dest.noiseCutoffEnvDepth, source.noiseCutoffEnvDepth);
+  fn (dest.noiseDamping, source.noiseDamping);
+  fn (dest.noiseAmount, source.noiseAmount);
+  fn (dest.noiseLevel, source.noiseLevel);
+  fn (dest.noiseBlendGain, source.noiseBlendGain);
+  fn (dest.noiseLpCoef, source.noiseLpCoef);
+  fn (dest.noiseHpCoef, source.noiseHpCoef);
+  fn (dest.drive, source.drive);
+  fn (dest.outputLevel, source.outputLevel);
+  fn (dest.ampDecayCoef, source.ampDecayCoef);
+  fn (dest.toneDecayCoef, source.toneDecayCoef);
+  fn (dest.pitchDecayCoef, source.pitchDecayCoef);
+  fn (dest.noiseDecayCoef, source.noiseDecayCoef);
+  fn (dest.transientDecayCoef, source.transientDecayCoef);
+  fn (dest.clickDecayCoef, source.clickDecayCoef);
+  fn (dest.toneControlDecay, source.toneControlDecay);
+  fn (dest.transientControlDecay, source.transientControlDecay);
+  fn (dest.noiseControlDecay, source.noiseControlDecay);
+}
+
+// Calls fn (destinationField, sourceField) for the levels and mix weights each path's output is
+// scaled by: the coefficients whose step a listener hears as a click.
+template <typename Dest, typename Source, typename Fn>
+void forEachGainCoefficient (VoiceCoefficientsT<Dest>& dest, const VoiceCoefficientsT<Source>& source, Fn&& fn)
+{
+  fn (dest.oscLevel, source.oscLevel);
+  fn (dest.bodyGain, source.bodyGain);
+  fn (dest.transientBlend, source.transientBlend);
+  fn (dest.transientGain, source.transientGain);
+  fn (dest.clickDepth, source.clickDepth);
+  fn (dest.toneBlend, source.toneBlend);
+  fn (dest.noiseAmount, source.noiseAmount);
+  fn (dest.noiseLevel, source.noiseLevel);
+  fn (dest.noiseBlendGain, source.noiseBlendGain);
+  fn (dest.drive, source.drive);
+  fn (dest.outputLevel, source.outputLevel);
+}
+
+// Filter cutoffs are re-evaluated every controlInterval samples and ramped linearly in between.
+constexpr int32_t kDefaultControlInterval = WCSD_CONTROL_INTERVAL;
+constexpr int32_t kMaxControlInterval = 256;
+constexpr double kControlReferenceRate = 48000.0;
+
+inline int32_t clampControlInterval (int32_t interval)
+{
+  return std::clamp (interval, int32_t {1}, kMaxControlInterval);
+}
+
+// The interval that keeps the control rate of kDefaultControlInterval at 48 kHz, so the filter
+// sweeps are resolved alike at every sample rate.
+inline int32_t controlIntervalFor (double sampleRate)
+{
+  const double interval = kDefaultControlInterval * (sampleRate / kControlReferenceRate);
+  return clampControlInterval (static_cast<int32_t> (std::lround (interval)));
+}
+
+inline double controlDecay (double decayCoef, int32_t controlInterval)
+{
+  return std::pow (decayCoef, static_cast<double> (controlInterval));
+}
+
+// frame must already be sanitized.
+inline VoiceCoefficients computeCoefficients (const LaneFrame& frame, double sampleRate, int32_t controlInterval)
+{
+  const size_t character = characterIndex (frame.character);
+  VoiceCoefficients c {};
+
+  c.frequencyHz = frame.frequencyHz;
+  c.pitchEnvAmount = frame.pitchEnvAmount;
+  c.pitchSemitoneSpan = kPitchSemitoneSpan[character];
+  c.fmAmount = frame.fmAmount;
+  c.fmScale = kFmScale[character];
+  c.modFrequencyScale = 1.0 + (frame.fmAmount * (5.5 * kFmScale[character]));
+  const double transFreqSweep = 0.7 + (frame.transientAmount * 1.5);
+  c.transientIncrement = (kTwoPi * kTransientBaseHz[character] * transFreqSweep) / sampleRate;
+  c.foldAmount = frame.foldAmount;
+
+  // Per-lane osc filter: 0 = nearly closed, 1 = full openness (no mid-neutral 0.4 floor)
+  const double oscClosedHz = 72.0;
+  const double oscOpenHz = std::max (140.0, frame.bodyFilterCutoffHz);
+  const double oscNorm = clamp01 (frame.oscFilterCutoff);
+  c.oscBaseCutoff = oscClosedHz + (oscOpenHz - oscClosedHz) * std::pow (oscNorm, 0.82);
+  c.oscEnvModDepth = c.oscBaseCutoff * frame.bodyFilterEnvAmount * frame.oscFilterEnvAmount;
+  c.oscCutoffMax = sampleRate * 0.47;
+  c.oscDamping =
+    svfDamping (std::min (0.98, (frame.bodyFilterResonance * 0.5 + frame.oscFilterResonance * 0.5) * 1.35));
+  c.oscLevel = frame.oscLevel;
+  c.bodyGain = kBodyGain[character];
+
+  c.transientBlend =
+    std::clamp ((frame.transientMix * 0.65) + (frame.snapAmount * kNoiseTransientBlend[character]), 0.0, 1.0);
+  c.transBaseCutoff = cutoffFromNormalized (frame.transFilterCutoff, 95.0, 20000.0);
+  c.transEnvModDepth = c.transBaseCutoff * frame.transFilterEnvAmount;
+  c.transCutoffMax = sampleRate * 0.43;
+  c.transDamping = svfDamping (std::min (0.96, frame.transFilterResonance * 1.35));
+  c.transientGain = (0.5 + (frame.transientAmount * 1.5)) * frame.transientLevel * kTransientGainBoost[character];
+  c.clickDepth = (0.42 + (frame.snapAmount * 0.55)) * (0.35 + (frame.transientAmount * 1.15));
+
+  c.snapAmount = frame.snapAmount;
+  c.toneBlend = clamp01 ((frame.noiseTone + 1.0) * 0.5);
+  c.snapExponent = std::clamp (0.85 - (frame.snapAmount * 0.55), 0.25, 1.0);
+  c.noiseCutoffBase = frame.noiseFilterCutoffHz * (0.45 + (c.toneBlend * 0.90));
+  c.noiseCutoffEnvDepth = 1.1 + (frame.noiseEnvAmount * 2.4);
+  c.noiseDamping = svfDamping (std::clamp (frame.noiseResonance + (frame.snapAmount * 0.16), 0.0, 0.98));
+  c.noiseAmount = frame.noiseAmount;
+  c.noiseLevel = frame.noiseLevel;
+  c.noiseBlendGain = kNoiseBlendGain[character];
+
+  const double tone01 = clamp01 ((frame.noiseTone + 1.0) * 0.5);
+  const double baseNoiseCutoff = frame.noiseFilterCutoffHz * (0.40 + (tone01 * 0.70));
+  const double lowCutoffHz = std::clamp (baseNoiseCutoff * 0.95, 180.0, 14000.0);
+  const double highCutoffHz = std::clamp (baseNoiseCutoff * 0.50, 100.0, 9000.0);
+  c.noiseLpCoef = std::clamp (1.0 - std::exp (-(kTwoPi * lowCutoffHz) / sampleRate), 0.0, 1.0);
+  c.noiseHpCoef = std::clamp (1.0 - std::exp (-(kTwoPi * highCutoffHz) / sampleRate), 0.0, 1.0);
+
+  c.drive = 1.0 + (frame.driveAmount * 6.0);
+  c.outputLevel = frame.outputLevel;
+
+  const double ampTau = frame.decaySeconds;
+  const double toneTau = std::max (0.01, frame.decaySeconds * 0.28);
+  const double pitchTau = frame.pitchEnvDecaySeconds;
+  const double noiseTau = frame.noiseDecaySeconds;
+  const double transientTau =
+    std::clamp (frame.transientDecaySeconds * (1.02 - (0.38 * frame.snapAmount)), 0.0012, 0.5);
+  c.ampDecayCoef = std::exp (-1.0 / (ampTau * sampleRate));
+  c.toneDecayCoef = std::exp (-1.0 / (toneTau * sampleRate));
+  c.pitchDecayCoef = std::exp (-1.0 / (pitchTau * sampleRate));
+  c.noiseDecayCoef = std::exp (-1.0 / (noiseTau * sampleRate));
+  c.transientDecayCoef = std::exp (-1.0 / (transientTau * sampleRate));
+  const double clickTauSec = std::clamp (0.00035 + (frame.snapAmount * 0.00055), 0.0002, 0.002);
+  c.clickDecayCoef = std::exp (-1.0 / (clickTauSec * sampleRate));
+
+  c.toneControlDecay = controlDecay (c.toneDecayCoef, controlInterval);
+  c.transientControlDecay = controlDecay (c.transientDecayCoef, controlInterval);
+  c.noiseControlDecay = controlDecay (c.noiseDecayCoef, controlInterval);
+
+  return c;
+}
+
+inline double laneValue (double value, size_t)
+{
+  return value;
+}
+
+template <typename T, size_t N>
+inline double laneValue (const std::array<T, N>& values, size_t lane)
+{
+  return values[lane];
+}
+
+template <typename T>
+inline T noiseContour (T noiseEnv, T snapAmount, T snapExponent)
+{
+  const T snappyEnv = voicePow (std::max (noiseEnv, T (0)), snapExponent);
+  return ((T (1) - snapAmount) * noiseEnv) + (snapAmount * snappyEnv);
+}
+
+// SVF coefficients of the osc, transient and noise filters.
+struct FilterCoefficients {
+  double osc {0.0};
+  double trans {0.0};
+  double noise {0.0};
+};
+
+// Exact filter coefficients of one voice (lane of c) at the given envelope levels.
+template <typename T>
+inline FilterCoefficients filterCoefficientsAt (const VoiceCoefficientsT<T>& c, size_t lane, double sampleRate,
+                                                double toneEnv, double transientEnv, double noiseEnv)
+{
+  FilterCoefficients f {};
+
+  const double oscEnvMod = laneValue (c.oscEnvModDepth, lane) * toneEnv * 4.5;
+  const double oscCutoffHz =
+    std::clamp (laneValue (c.oscBaseCutoff, lane) + oscEnvMod, 20.0, laneValue (c.oscCutoffMax, lane));
+  f.osc = svfCoefficient (oscCutoffHz, sampleRate);
+
+  const double transEnvMod = laneValue (c.transEnvModDepth, lane) * transientEnv * 4.0;
+  const double transCutoffHz =
+    std::clamp (laneValue (c.transBaseCutoff, lane) + transEnvMod, 70.0, laneValue (c.transCutoffMax, lane));
+  f.trans = svfCoefficient (transCutoffHz, sampleRate);
+
+  const double contour =
+    noiseContour (noiseEnv, laneValue (c.snapAmount, lane), laneValue (c.snapExponent, lane));
+  const double noiseCutoffHz = std::clamp (
+    laneValue (c.noiseCutoffBase, lane) * (0.60 + (contour * laneValue (c.noiseCutoffEnvDepth, lane))), 180.0,
+    19000.0);
+  f.noise = svfCoefficient (noiseCutoffHz, sampleRate);
+
+  return f;
+}
+
+// How far the scheduled (interpolated) filter coefficients strayed from the exact per-sample ones.
+struct CoefficientErrorStats {
+  double maxAbsError {0.0};
+  double sumSquaredError {0.0};
+  uint64_t count {0};
+};
+
+inline void accumulateCoefficientError (CoefficientErrorStats& stats, const FilterCoefficients& scheduled,
+                                        const FilterCoefficients& exact)
+{
+  for (const double error : {scheduled.osc - exact.osc, scheduled.trans - exact.trans,
+                             scheduled.noise - exact.noise})
+  {
+    stats.maxAbsError = std::max (stats.maxAbsError, std::abs (error));
+    stats.sumSquaredError += error * error;
+    ++stats.count;
+  }
+}
+
+inline double rmsError (const CoefficientErrorStats& stats)
+{
+  return stats.count > 0 ? std::sqrt (stats.sumSquaredError / static_cast<double> (stats.count)) : 0.0;
+}
+
+// Envelope levels below which a voice stops rendering.
+constexpr double kVoiceEnvFloor = 0.00008;
+constexpr double kVoiceClickFloor = 0.00002;
+
+// Signal paths of one voice. A path whose envelope has fallen below kVoiceEnvFloor, or whose gain
+// is zero for the whole hit, stops rendering and has its filter state flushed.
+constexpr uint32_t kOscPath = 1u << 0;
+constexpr uint32_t kTransientPath = 1u << 1;
+constexpr uint32_t kNoisePath = 1u << 2;
+
+// Paths that can contribute anything for the triggered coefficients (lane of c).
+template <typename T>
+inline uint32_t audiblePaths (const VoiceCoefficientsT<T>& c, size_t lane)
+{
+  uint32_t paths = 0;
+  if (laneValue (c.oscLevel, lane) > 0.0)
+    paths |= kOscPath;
+  if (laneValue (c.transientGain, lane) > 0.0)
+    paths |= kTransientPath;
+  if (laneValue (c.noiseAmount, lane) * laneValue (c.noiseLevel, lane) > 0.0)
+    paths |= kNoisePath;
+  return paths;
+}
+
+// Optional stages of the osc path. With a zero per-trigger amount each one is an exact identity
+// (pitch ratio 1, zero FM depth, unity fold gain on a sine); the voice bank selects the fold per
+// lane on its bit and runs the other two on every lane.
+constexpr uint32_t kPitchSweepStage = 1u << 0;
+constexpr uint32_t kFmStage = 1u << 1;
+constexpr uint32_t kFoldStage = 1u << 2;
+
+template <typename T>
+inline uint32_t activeOscStages (const VoiceCoefficientsT<T>& c, size_t lane)
+{
+  uint32_t stages = 0;
+  if (laneValue (c.pitchEnvAmount, lane) > 0.0)
+    stages |= kPitchSweepStage;
+  if (laneValue (c.fmAmount, lane) > 0.0)
+    stages |= kFmStage;
+  if (laneValue (c.foldAmount, lane) > 0.0)
+    stages |= kFoldStage;
+  return stages;
+}
+
+// Anti-click crossfade length used when a ringing voice is retriggered.
+inline int32_t antiClickLengthFor (double sampleRate)
+{
+  return std::max (32, static_cast<int32_t> (sampleRate * 0.0008));
+}
+
+} // namespace Steinberg::WestCoastDrumSynth::VoiceDsp
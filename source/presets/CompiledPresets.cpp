@@ -0,0 +1,124 @@
+#include "presets/CompiledPresets.h"
+
+#include "engine/LaneFrameBuilder.h"
+
+#include <algorithm>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+namespace {
+
+void set (ParameterImage& params, Vst::ParamID id, double normalized)
+{
+  params[denseParamIndex (id)] = std::clamp (normalized, 0.0, 1.0);
+}
+
+double normalizedFromPresetIndex (int32 presetIndex)
+{
+  if (kFactoryPresetCount <= 1)
+    return 0.0;
+  return static_cast<double> (presetIndex) / static_cast<double> (kFactoryPresetCount - 1);
+}
+
+CompiledPreset compile (const FactoryPreset& preset, int32 presetIndex)
+{
+  CompiledPreset compiled;
+  ParameterImage& params = compiled.params;
+  set (params, kParamMaster, preset.master);
+  set (params, kParamInternalTempo, preset.internalTempo);
+  set (params, kParamSwing, preset.swing);
+  set (params, kParamPresetSelect, normalizedFromPresetIndex (presetIndex));
+
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    const auto& lanePreset = preset.lanes[lane];
+    set (params, laneParamID (lane, kLaneTune), lanePreset.tune);
+    set (params, laneParamID (lane, kLaneDecay), lanePreset.decay);
+    set (params, laneParamID (lane, kLaneFold), lanePreset.fold);
+    set (params, laneParamID (lane, kLaneFm), lanePreset.fm);
+    set (params, laneParamID (lane, kLaneNoise), lanePreset.noise);
+    set (params, laneParamID (lane, kLaneDrive), lanePreset.drive);
+    set (params, laneParamID (lane, kLaneLevel), lanePreset.level);
+    set (params, laneParamID (lane, kLanePan), lanePreset.pan);
+    set (params, laneExtraParamID (lane, kLanePitchEnvAmount), lanePreset.pitchEnvAmount);
+    set (params, laneExtraParamID (lane, kLanePitchEnvDecay), lanePreset.pitchEnvDecay);
+    set (params, laneExtraParamID (lane, kLaneTransientAttack), lanePreset.transientAttack);
+    set (params, laneExtraParamID (lane, kLaneNoiseTone), lanePreset.noiseTone);
+    set (params, laneExtraParamID (lane, kLaneNoiseDecay), lanePreset.noiseDecay);
+    set (params, laneExtraParamID (lane, kLaneSnap), lanePreset.snap);
+    // The macros are derived from the preset's core values rather than stored per preset.
+    set (params, laneMacroParamID (lane, kLaneTransientDecay), 0.18 + (lanePreset.decay * 0.62));
+    set (params, laneMacroParamID (lane, kLaneTransientMix), 0.24 + (lanePreset.transientAttack * 0.70));
+    set (params, laneMacroParamID (lane, kLaneNoiseResonance), 0.20 + (lanePreset.snap * 0.68));
+    set (params, laneMacroParamID (lane, kLaneNoiseEnvAmount), 0.28 + (lanePreset.noiseDecay * 0.56));
+    set (params, laneFilterParamID (lane, kLaneOscFilterCutoff), lanePreset.oscFilterCutoff);
+    set (params, laneFilterParamID (lane, kLaneOscFilterRes), lanePreset.oscFilterRes);
+    set (params, laneFilterParamID (lane, kLaneOscFilterEnv), lanePreset.oscFilterEnv);
+    set (params, laneFilterParamID (lane, kLaneTransFilterCutoff), lanePreset.transFilterCutoff);
+    set (params, laneFilterParamID (lane, kLaneTransFilterRes), lanePreset.transFilterRes);
+    set (params, laneFilterParamID (lane, kLaneTransFilterEnv), lanePreset.transFilterEnv);
+    set (params, laneOscMixParamID (lane), 1.0);
+  }
+
+  ParameterImage frameInputs = params;
+  set (frameInputs, kParamOscFilterCutoff, kCompiledPresetOscFilterCutoff);
+  set (frameInputs, kParamOscFilterResonance, kCompiledPresetOscFilterResonance);
+  set (frameInputs, kParamOscFilterEnv, kCompiledPresetOscFilterEnv);
+  set (frameInputs, kParamRandomizeAmount, kCompiledPresetMorph);
+  buildLaneFrames (frameInputs, kAllLanesMask, compiled.frames);
+  compiled.pattern = &preset.pattern;
+  return compiled;
+}
+
+constexpr std::array<int16, kPresetParamSlotCount> makePresetParamSlots ()
+{
+  std::array<int16, kPresetParamSlotCount> slots {};
+  int32 count = 0;
+  for (const auto id : {kParamMaster, kParamInternalTempo, kParamSwing, kParamPresetSelect})
+    slots[count++] = static_cast<int16> (denseParamIndex (id));
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    for (int32 slot = 0; slot < kLaneDenseLedOffset; ++slot)
+      slots[count++] = static_cast<int16> (laneDenseIndex (lane, slot));
+    slots[count++] = static_cast<int16> (laneDenseIndex (lane, kLaneDenseOscMixOffset));
+  }
+  return slots;
+}
+
+constexpr auto kPresetParamSlots = makePresetParamSlots ();
+static_assert (kPresetParamSlots.back () == laneDenseIndex (kLaneCount - 1, kLaneDenseOscMixOffset));
+
+} // namespace
+
+const std::array<int16, kPresetParamSlotCount>& getPresetParamSlots ()
+{
+  return kPresetParamSlots;
+}
+
+const std::array<CompiledPreset, kFactoryPresetCount>& getCompiledPresets ()
+{
+  static const std::array<CompiledPreset, kFactoryPresetCount> compiled = [] ()
+  {
+    std::array<CompiledPreset, kFactoryPresetCount> presets {};
+    const auto& factory = getFactoryPresets ();
+    for (int32 i = 0; i < kFactoryPresetCount; ++i)
+      presets[i] = compile (factory[i], i);
+    return presets;
+  }();
+  return compiled;
+}
+
+bool compiledFramesMatch (const ParameterImage& params)
+{
+  return params[denseParamIndex (kParamOscFilterCutoff)] == kCompiledPresetOscFilterCutoff &&
+         params[denseParamIndex (kParamOscFilterResonance)] == kCompiledPresetOscFilterResonance &&
+         params[denseParamIndex (kParamOscFilterEnv)] == kCompiledPresetOscFilterEnv &&
+         compiledMorphMatches (params);
+}
+
+bool compiledMorphMatches (const ParameterImage& params)
+{
+  return params[denseParamIndex (kParamRandomizeAmount)] == kCompiledPresetMorph;
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ParameterIds.h"
+#include "engine/LaneFrame.h"
+#include "presets/FactoryPresets.h"
+
+#include <array>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+// Parameter slots a factory preset sets: master, tempo, swing, preset select, and every sound
+// parameter plus the osc mix of each lane. In ascending dense store order.
+constexpr int32 kPresetParamSlotCount =
+  4 + (kLaneCount * (kLaneDenseFilterOffset + kLaneFilterParamCount + 1));
+
+// A factory preset expanded once into what the processor needs to switch to it: its values in
+// the dense store layout (only kPresetParamSlots are meaningful) and the lane frames they give
+// with the global osc filter and morph at kCompiledPreset* below.
+struct CompiledPreset {
+  ParameterImage params {};
+  std::array<LaneFrame, kLaneCount> frames {};
+  const PatternGrid* pattern {nullptr};
+};
+
+constexpr double kCompiledPresetOscFilterCutoff = 0.20;
+constexpr double kCompiledPresetOscFilterResonance = 0.34;
+constexpr double kCompiledPresetOscFilterEnv = 0.46;
+constexpr double kCompiledPresetMorph = 0.5;
+
+const std::array<int16, kPresetParamSlotCount>& getPresetParamSlots ();
+
+// Built on first use; call it off the audio thread (initialize) before process () needs it.
+const std::array<CompiledPreset, kFactoryPresetCount>& getCompiledPresets ();
+
+// True when frames of a CompiledPreset match what buildLaneFrames () gives for params, i.e. the
+// parameters outside the preset still sit at the values the banks were compiled with.
+bool compiledFramesMatch (const ParameterImage& params);
+
+// True when params has the morph the banks were compiled with. The frames then differ from what
+// buildLaneFrames () gives at most in the fields applyGlobalOscFilter () sets.
+bool compiledMorphMatches (const ParameterImage& params);
+
+} // namespace Steinberg::WestCoastDrumSynth
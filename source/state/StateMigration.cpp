@@ -0,0 +1,492 @@
+#include "state/StateMigration.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+namespace {
+
+constexpr uint32 kV10StateVersion = 10;
+constexpr uint32 kV9StateVersion = 9;
+constexpr uint32 kV8StateVersion = 8;
+constexpr uint32 kV7StateVersion = 7;
+constexpr uint32 kV6StateVersion = 6;
+constexpr uint32 kV5StateVersion = 5;
+constexpr uint32 kV4StateVersion = 4;
+constexpr uint32 kV3StateVersion = 3;
+constexpr uint32 kPreviousStateVersion = 2;
+constexpr uint32 kLegacyStateVersion = 1;
+constexpr int32 kV4LaneCount = 5;
+constexpr int32 kLegacyLaneCount = 4;
+constexpr int32 kPreviousGlobalParamCount = 6;
+
+// v1-v8 store a uint32 version and an int32 preset index, then one little-endian double per
+// parameter. v9 extends the header with the block encoding, the parameter count and an FNV-1a
+// checksum over the rest of the header and the block, then stores allParameterIds () order in
+// that encoding. v10 adds the randomizer seed and generation (uint64 each) before the checksum.
+// v11 keeps the v10 header, and its count may be anything up to the current list: parameters are
+// only ever appended to allParameterIds (), so a chunk of fewer is a prefix, and
+// finishCurrentState fills in the ones after it.
+constexpr int32 kStateHeaderBytes = 8;
+constexpr int32 kV9StateHeaderBytes = 20;
+constexpr int32 kV9ChecksumOffset = 16;
+constexpr int32 kRandomizerOffset = 16;
+constexpr int32 kV10StateHeaderBytes = 36;
+constexpr int32 kV10ChecksumOffset = 32;
+constexpr int32 kMaxStoredParams = std::max (kTotalParameterCount, kV7TotalParameterCount);
+
+// Dense store slot for each stored double of one version, -1 for values that have no place
+// in the current parameter set (e.g. the ninth lane of v5-v7).
+struct StoredSlotMap {
+  std::array<int16, kMaxStoredParams> slots {};
+  int32 count {0};
+
+  constexpr void add (Vst::ParamID id) { slots[count++] = static_cast<int16> (denseParamIndex (id)); }
+  constexpr void skip () { slots[count++] = -1; }
+};
+
+struct StateLayout {
+  uint32 version;
+  StoredSlotMap map;
+  // Fills in what the version did not store, after the stored values are in place.
+  void (*finish) (ParameterStateSnapshot& snapshot);
+};
+
+// v1-v3 had six globals and lane-major groups for the lanes that existed at the time.
+template <int32 LaneCount>
+constexpr void addLegacyLaneGroups (StoredSlotMap& map, bool withExtra, bool withMacro)
+{
+  for (int32 lane = 0; lane < LaneCount; ++lane)
+    for (int32 p = 0; p < kLaneParamCount; ++p)
+      map.add (laneParamID (lane, static_cast<LaneParamOffset> (p)));
+  if (withExtra)
+  {
+    for (int32 lane = 0; lane < LaneCount; ++lane)
+      for (int32 p = 0; p < kLaneExtraParamCount; ++p)
+        map.add (laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p)));
+  }
+  if (withMacro)
+  {
+    for (int32 lane = 0; lane < LaneCount; ++lane)
+      for (int32 p = 0; p < kLaneMacroParamCount; ++p)
+        map.add (laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (p)));
+  }
+}
+
+constexpr StoredSlotMap makeLegacySlotMap (uint32 version)
+{
+  StoredSlotMap map;
+  for (int32 i = 0; i < kPreviousGlobalParamCount; ++i)
+    map.add (static_cast<Vst::ParamID> (i));
+  if (version == kLegacyStateVersion)
+    addLegacyLaneGroups<kLegacyLaneCount> (map, false, false);
+  else
+    addLegacyLaneGroups<kV4LaneCount> (map, true, version == kV3StateVersion);
+  return map;
+}
+
+// v4-v6 are read as a prefix of the ID list of their time's layout.
+template <size_t N>
+constexpr StoredSlotMap makePrefixSlotMap (const std::array<Vst::ParamID, N>& ids, int32 count)
+{
+  StoredSlotMap map;
+  for (int32 i = 0; i < count; ++i)
+    map.add (ids[static_cast<size_t> (i)]);
+  return map;
+}
+
+// v7 had nine lanes; its lane 6 was dropped and lane 8 moved into slot 6.
+constexpr int32 v7DestinationLane (int32 sourceLane)
+{
+  if (sourceLane == 6)
+    return -1;
+  return sourceLane == 8 ? 6 : sourceLane;
+}
+
+constexpr StoredSlotMap makeV7SlotMap ()
+{
+  StoredSlotMap map;
+  for (int32 i = 0; i < kParamGlobalCount; ++i)
+    map.add (static_cast<Vst::ParamID> (i));
+
+  const auto addGroup = [&map] (int32 groupSize, auto idForLane) {
+    for (int32 lane = 0; lane < kV7LaneCount; ++lane)
+    {
+      const int32 destLane = v7DestinationLane (lane);
+      for (int32 p = 0; p < groupSize; ++p)
+      {
+        if (destLane < 0)
+          map.skip ();
+        else
+          map.add (idForLane (destLane, p));
+      }
+    }
+  };
+  addGroup (kLaneParamCount, [] (int32 lane, int32 p) { return laneParamID (lane, static_cast<LaneParamOffset> (p)); });
+  addGroup (kLaneExtraParamCount,
+            [] (int32 lane, int32 p) { return laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p)); });
+  addGroup (kLaneMacroParamCount,
+            [] (int32 lane, int32 p) { return laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (p)); });
+  addGroup (kLaneFilterParamCount,
+            [] (int32 lane, int32 p) { return laneFilterParamID (lane, static_cast<LaneFilterParamOffset> (p)); });
+  addGroup (1, [] (int32 lane, int32) { return laneLedParamID (lane); });
+  addGroup (1, [] (int32 lane, int32) { return laneMuteParamID (lane); });
+  addGroup (1, [] (int32 lane, int32) { return laneOscMixParamID (lane); });
+  return map;
+}
+
+void assign (ParameterStateSnapshot& snapshot, Vst::ParamID id, double value)
+{
+  const int32 slot = denseParamIndex (id);
+  if (slot < 0)
+    return;
+  snapshot.values[slot] = value;
+  snapshot.assigned.set (static_cast<size_t> (slot));
+}
+
+double valueOf (const ParameterStateSnapshot& snapshot, Vst::ParamID id)
+{
+  return snapshot.values[denseParamIndex (id)];
+}
+
+void applyGlobalOscFilterDefaults (ParameterStateSnapshot& snapshot)
+{
+  assign (snapshot, kParamOscFilterCutoff, 0.20);
+  assign (snapshot, kParamOscFilterResonance, 0.34);
+  assign (snapshot, kParamOscFilterEnv, 0.46);
+}
+
+// Lane groups from firstLane on get their defaults; core parameters sit at the centre.
+void applyLaneDefaults (ParameterStateSnapshot& snapshot, int32 firstLane, bool core, bool extra, bool macro,
+                        bool filter)
+{
+  for (int32 lane = firstLane; lane < kLaneCount; ++lane)
+  {
+    if (core)
+    {
+      for (int32 p = 0; p < kLaneParamCount; ++p)
+        assign (snapshot, laneParamID (lane, static_cast<LaneParamOffset> (p)), 0.5);
+    }
+    if (extra)
+    {
+      for (int32 p = 0; p < kLaneExtraParamCount; ++p)
+        assign (snapshot, laneExtraParamID (lane, static_cast<LaneExtraParamOffset> (p)), kLaneExtraDefaults[lane][p]);
+    }
+    if (macro)
+    {
+      for (int32 p = 0; p < kLaneMacroParamCount; ++p)
+        assign (snapshot, laneMacroParamID (lane, static_cast<LaneMacroParamOffset> (p)), kLaneMacroDefaults[lane][p]);
+    }
+    if (filter)
+    {
+      for (int32 p = 0; p < kLaneFilterParamCount; ++p)
+        assign (snapshot, laneFilterParamID (lane, static_cast<LaneFilterParamOffset> (p)),
+                kLaneFilterDefaults[lane][p]);
+    }
+  }
+}
+
+void finishLegacyState (ParameterStateSnapshot& snapshot)
+{
+  // v1 had four lanes; the fifth starts as a copy of the fourth, panned slightly right.
+  for (int32 p = 0; p < kLaneParamCount; ++p)
+  {
+    const auto offset = static_cast<LaneParamOffset> (p);
+    double value = valueOf (snapshot, laneParamID (3, offset));
+    if (offset == kLanePan)
+      value = std::clamp (value + 0.08, 0.0, 1.0);
+    assign (snapshot, laneParamID (4, offset), value);
+  }
+  applyLaneDefaults (snapshot, 0, false, true, true, true);
+  applyGlobalOscFilterDefaults (snapshot);
+}
+
+void finishV2State (ParameterStateSnapshot& snapshot)
+{
+  applyLaneDefaults (snapshot, kV4LaneCount, true, true, false, false);
+  applyLaneDefaults (snapshot, 0, false, false, true, true);
+  applyGlobalOscFilterDefaults (snapshot);
+}
+
+void finishV3State (ParameterStateSnapshot& snapshot)
+{
+  applyLaneDefaults (snapshot, kV4LaneCount, true, true, true, false);
+  applyLaneDefaults (snapshot, 0, false, false, false, true);
+  applyGlobalOscFilterDefaults (snapshot);
+}
+
+void finishV4State (ParameterStateSnapshot& snapshot)
+{
+  applyLaneDefaults (snapshot, kV4LaneCount, true, true, true, true);
+}
+
+void finishV5State (ParameterStateSnapshot& snapshot)
+{
+  assign (snapshot, kParamRandomizeAmount, 1.0);
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    assign (snapshot, laneMuteParamID (lane), 0.0);
+    assign (snapshot, laneOscMixParamID (lane), 1.0);
+  }
+}
+
+void finishV6State (ParameterStateSnapshot& snapshot)
+{
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+    assign (snapshot, laneOscMixParamID (lane), 1.0);
+}
+
+void finishV7State (ParameterStateSnapshot&) {}
+
+constexpr int32 kV8StoredCount = kTotalParameterCount - kTrailingGlobalParamCount - kLaneOversamplingParamCount;
+
+void finishCurrentState (ParameterStateSnapshot& snapshot)
+{
+  // A stored osc mix of zero loads as full osc level.
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    if (valueOf (snapshot, laneOscMixParamID (lane)) < 1e-6)
+      assign (snapshot, laneOscMixParamID (lane), 1.0);
+  }
+
+  // The kit morph, quality and oversampling parameters appended after the v8 set all start at zero.
+  static constexpr auto ids = allParameterIds ();
+  for (size_t i = kV8StoredCount; i < ids.size (); ++i)
+  {
+    if (!snapshot.assigned.test (static_cast<size_t> (denseParamIndex (ids[i]))))
+      assign (snapshot, ids[i], 0.0);
+  }
+}
+
+constexpr int32 kV4StoredCount = kParamGlobalCount + (kV4LaneCount * kLaneParamCount) +
+                                 (kV4LaneCount * kLaneExtraParamCount) + (kV4LaneCount * kLaneMacroParamCount) +
+                                 (kV4LaneCount * kLaneFilterParamCount);
+constexpr int32 kV5StoredCount = kV7TotalParameterCount - kV7LaneCount - kV7LaneCount - 1;
+constexpr int32 kV6StoredCount = kV7TotalParameterCount - kV7LaneCount;
+
+// Indexed by version - 1.
+constexpr std::array<StateLayout, kStateVersion> kStateLayouts {{
+  {kLegacyStateVersion, makeLegacySlotMap (kLegacyStateVersion), finishLegacyState},
+  {kPreviousStateVersion, makeLegacySlotMap (kPreviousStateVersion), finishV2State},
+  {kV3StateVersion, makeLegacySlotMap (kV3StateVersion), finishV3State},
+  {kV4StateVersion, makePrefixSlotMap (allParameterIds (), kV4StoredCount), finishV4State},
+  {kV5StateVersion, makePrefixSlotMap (allParameterIdsV7 (), kV5StoredCount), finishV5State},
+  {kV6StateVersion, makePrefixSlotMap (allParameterIdsV7 (), kV6StoredCount), finishV6State},
+  {kV7StateVersion, makeV7SlotMap (), finishV7State},
+  {kV8StateVersion, makePrefixSlotMap (allParameterIds (), kV8StoredCount), finishCurrentState},
+  {kV9StateVersion, makePrefixSlotMap (allParameterIds (), kTotalParameterCount), finishCurrentState},
+  {kV10StateVersion, makePrefixSlotMap (allParameterIds (), kTotalParameterCount), finishCurrentState},
+  {kStateVersion, makePrefixSlotMap (allParameterIds (), kTotalParameterCount), finishCurrentState},
+}};
+
+constexpr const StateLayout& kCurrentLayout = kStateLayouts[kStateVersion - 1];
+
+static_assert (kStateLayouts[0].map.count == 38);
+static_assert (kStateLayouts[1].map.count == 76);
+static_assert (kStateLayouts[2].map.count == 96);
+static_assert (kStateLayouts[6].map.count == kV7TotalParameterCount);
+static_assert (kStateLayouts[7].map.count == kV8StoredCount);
+static_assert (kCurrentLayout.map.count == kTotalParameterCount);
+
+uint32 readLittleEndianUInt32 (const uint8* bytes)
+{
+  return static_cast<uint32> (bytes[0]) | (static_cast<uint32> (bytes[1]) << 8) |
+         (static_cast<uint32> (bytes[2]) << 16) | (static_cast<uint32> (bytes[3]) << 24);
+}
+
+void writeLittleEndianUInt32 (uint8* bytes, uint32 value)
+{
+  for (int32 i = 0; i < 4; ++i)
+    bytes[i] = static_cast<uint8> (value >> (8 * i));
+}
+
+uint64 readLittleEndianUInt64 (const uint8* bytes)
+{
+  uint64 value = 0;
+  for (int32 i = 7; i >= 0; --i)
+    value = (value << 8) | bytes[i];
+  return value;
+}
+
+void writeLittleEndianUInt64 (uint8* bytes, uint64 value)
+{
+  for (int32 i = 0; i < 8; ++i)
+    bytes[i] = static_cast<uint8> (value >> (8 * i));
+}
+
+double readLittleEndianDouble (const uint8* bytes)
+{
+  return std::bit_cast<double> (readLittleEndianUInt64 (bytes));
+}
+
+void writeLittleEndianDouble (uint8* bytes, double value)
+{
+  writeLittleEndianUInt64 (bytes, std::bit_cast<uint64> (value));
+}
+
+uint16 quantize16 (double value)
+{
+  return static_cast<uint16> (std::lround (std::clamp (value, 0.0, 1.0) * 65535.0));
+}
+
+double dequantize16 (const uint8* bytes)
+{
+  const auto quantized = static_cast<uint16> (bytes[0] | (bytes[1] << 8));
+  return static_cast<double> (quantized) / 65535.0;
+}
+
+uint32 fnv1a (const uint8* bytes, size_t numBytes, uint32 hash = 2166136261u)
+{
+  for (size_t i = 0; i < numBytes; ++i)
+    hash = (hash ^ bytes[i]) * 16777619u;
+  return hash;
+}
+
+int32 encodedValueBytes (StateEncoding encoding)
+{
+  return encoding == StateEncoding::Quantized16 ? 2 : 8;
+}
+
+bool readExactly (IBStream* state, void* buffer, int32 numBytes)
+{
+  int32 numBytesRead = 0;
+  return state->read (buffer, numBytes, &numBytesRead) == kResultOk && numBytesRead == numBytes;
+}
+
+// Reads and verifies the parameter block of a v9+ chunk whose header is complete. The block holds
+// the first count entries of the layout, count being any number up to all of them.
+bool readChecksummedBlock (IBStream* state, const std::array<uint8, kV10StateHeaderBytes>& header,
+                           int32 checksumOffset, const StateLayout& layout, ParameterStateSnapshot& snapshot)
+{
+  const auto encoding = static_cast<StateEncoding> (readLittleEndianUInt32 (header.data () + 8));
+  if (encoding != StateEncoding::Float64 && encoding != StateEncoding::Quantized16)
+    return false;
+  const uint32 storedCount = readLittleEndianUInt32 (header.data () + 12);
+  if (storedCount > static_cast<uint32> (layout.map.count))
+    return false;
+
+  const auto count = static_cast<int32> (storedCount);
+  const int32 valueBytes = encodedValueBytes (encoding);
+  std::array<uint8, kTotalParameterCount * sizeof (double)> block {};
+  const int32 blockBytes = count * valueBytes;
+  if (!readExactly (state, block.data (), blockBytes))
+    return false;
+
+  const uint32 checksum = fnv1a (block.data (), static_cast<size_t> (blockBytes),
+                                 fnv1a (header.data () + 4, static_cast<size_t> (checksumOffset - 4)));
+  if (checksum != readLittleEndianUInt32 (header.data () + checksumOffset))
+    return false;
+
+  for (int32 i = 0; i < count; ++i)
+  {
+    const int16 slot = layout.map.slots[i];
+    const uint8* bytes = block.data () + (i * valueBytes);
+    snapshot.values[slot] =
+      encoding == StateEncoding::Quantized16 ? dequantize16 (bytes) : readLittleEndianDouble (bytes);
+    snapshot.assigned.set (static_cast<size_t> (slot));
+  }
+  layout.finish (snapshot);
+  return true;
+}
+
+} // namespace
+
+bool readParameterState (IBStream* state, ParameterStateSnapshot& snapshot)
+{
+  if (!state)
+    return false;
+
+  std::array<uint8, kV10StateHeaderBytes> header {};
+  if (!readExactly (state, header.data (), kStateHeaderBytes))
+    return false;
+
+  const uint32 version = readLittleEndianUInt32 (header.data ());
+  if (version < kLegacyStateVersion || version > kStateVersion)
+    return false;
+
+  snapshot.version = version;
+  snapshot.presetIndex = static_cast<int32> (readLittleEndianUInt32 (header.data () + 4));
+  snapshot.assigned.reset ();
+  snapshot.hasRandomizer = false;
+
+  if (version == kV9StateVersion)
+  {
+    if (!readExactly (state, header.data () + kStateHeaderBytes, kV9StateHeaderBytes - kStateHeaderBytes))
+      return false;
+    return readChecksummedBlock (state, header, kV9ChecksumOffset, kStateLayouts[version - 1], snapshot);
+  }
+  if (version >= kV10StateVersion)
+  {
+    if (!readExactly (state, header.data () + kStateHeaderBytes, kV10StateHeaderBytes - kStateHeaderBytes))
+      return false;
+    if (!readChecksummedBlock (state, header, kV10ChecksumOffset, kStateLayouts[version - 1], snapshot))
+      return false;
+    snapshot.randomizer.seed = readLittleEndianUInt64 (header.data () + kRandomizerOffset);
+    snapshot.randomizer.generation = readLittleEndianUInt64 (header.data () + kRandomizerOffset + 8);
+    snapshot.hasRandomizer = true;
+    return true;
+  }
+
+  const StateLayout& layout = kStateLayouts[version - 1];
+  std::array<uint8, kMaxStoredParams * sizeof (double)> block {};
+  const int32 blockBytes = layout.map.count * static_cast<int32> (sizeof (double));
+  if (!readExactly (state, block.data (), blockBytes))
+    return false;
+
+  for (int32 i = 0; i < layout.map.count; ++i)
+  {
+    const int16 slot = layout.map.slots[i];
+    if (slot < 0)
+      continue;
+    snapshot.values[slot] = readLittleEndianDouble (block.data () + (i * sizeof (double)));
+    snapshot.assigned.set (static_cast<size_t> (slot));
+  }
+  layout.finish (snapshot);
+  return true;
+}
+
+bool writeParameterState (IBStream* state, int32 presetIndex, const ParameterImage& values,
+                          const RandomizerState& randomizer, StateEncoding encoding)
+{
+  if (!state)
+    return false;
+
+  std::array<uint8, kV10StateHeaderBytes + (kTotalParameterCount * sizeof (double))> chunk {};
+  uint8* block = chunk.data () + kV10StateHeaderBytes;
+  const int32 valueBytes = encodedValueBytes (encoding);
+  for (int32 i = 0; i < kCurrentLayout.map.count; ++i)
+  {
+    const double value = values[kCurrentLayout.map.slots[i]];
+    uint8* bytes = block + (i * valueBytes);
+    if (encoding == StateEncoding::Quantized16)
+    {
+      const uint16 quantized = quantize16 (value);
+      bytes[0] = static_cast<uint8> (quantized);
+      bytes[1] = static_cast<uint8> (quantized >> 8);
+    }
+    else
+    {
+      writeLittleEndianDouble (bytes, value);
+    }
+  }
+
+  const int32 blockBytes = kCurrentLayout.map.count * valueBytes;
+  writeLittleEndianUInt32 (chunk.data (), kStateVersion);
+  writeLittleEndianUInt32 (chunk.data () + 4, static_cast<uint32> (presetIndex));
+  writeLittleEndianUInt32 (chunk.data () + 8, static_cast<uint32> (encoding));
+  writeLittleEndianUInt32 (chunk.data () + 12, static_cast<uint32> (kCurrentLayout.map.count));
+  writeLittleEndianUInt64 (chunk.data () + kRandomizerOffset, randomizer.seed);
+  writeLittleEndianUInt64 (chunk.data () + kRandomizerOffset + 8, randomizer.generation);
+  writeLittleEndianUInt32 (chunk.data () + kV10ChecksumOffset,
+                           fnv1a (block, static_cast<size_t> (blockBytes),
+                                  fnv1a (chunk.data () + 4, kV10ChecksumOffset - 4)));
+
+  const int32 chunkBytes = kV10StateHeaderBytes + blockBytes;
+  int32 numBytesWritten = 0;
+  return state->write (chunk.data (), chunkBytes, &numBytesWritten) == kResultOk && numBytesWritten == chunkBytes;
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
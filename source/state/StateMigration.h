@@ -0,0 +1,95 @@
+#pragma once
+
+#include "ParameterIds.h"
+#include "engine/ParameterRandomizer.h"
+
+#include "pluginterfaces/base/ibstream.h"
+
+#include <array>
+#include <bitset>
+
+namespace Steinberg::WestCoastDrumSynth {
+
+// Version written by WestCoastProcessor::getState. Versions 1 to kStateVersion - 1 still load
+// through the migration table in StateMigration.cpp.
+constexpr uint32 kStateVersion = 11;
+
+// How a v9+ chunk stores its parameter block. Quantized16 keeps every value within
+// kQuantizedStateTolerance of the saved one, with 0 and 1 exact, at a quarter of the size.
+enum class StateEncoding : uint32 {
+  Float64 = 0,
+  Quantized16 = 1,
+};
+
+constexpr double kQuantizedStateTolerance = 0.5 / 65535.0;
+
+// Lane defaults for the parameter groups that older states did not store yet. The controller
+// also registers them as the parameter defaults.
+inline constexpr std::array<std::array<double, kLaneExtraParamCount>, kLaneCount> kLaneExtraDefaults {{
+  {{0.84, 0.30, 0.76, 0.36, 0.26, 0.24}},
+  {{0.46, 0.48, 0.62, 0.72, 0.58, 0.84}},
+  {{0.20, 0.22, 0.38, 0.90, 0.20, 0.72}},
+  {{0.42, 0.38, 0.48, 0.52, 0.42, 0.48}},
+  {{0.44, 0.36, 0.50, 0.54, 0.44, 0.50}},
+  {{0.52, 0.34, 0.54, 0.60, 0.40, 0.56}},
+  {{0.38, 0.45, 0.62, 0.72, 0.58, 0.65}},
+  {{0.48, 0.40, 0.58, 0.68, 0.52, 0.72}},
+}};
+
+inline constexpr std::array<std::array<double, kLaneMacroParamCount>, kLaneCount> kLaneMacroDefaults {{
+  {{0.28, 0.44, 0.34, 0.56}},
+  {{0.38, 0.56, 0.50, 0.72}},
+  {{0.20, 0.36, 0.66, 0.86}},
+  {{0.32, 0.48, 0.40, 0.54}},
+  {{0.34, 0.46, 0.42, 0.56}},
+  {{0.36, 0.50, 0.44, 0.58}},
+  {{0.28, 0.54, 0.55, 0.68}},
+  {{0.30, 0.52, 0.50, 0.62}},
+}};
+
+inline constexpr std::array<std::array<double, kLaneFilterParamCount>, kLaneCount> kLaneFilterDefaults {{
+  {{0.65, 0.08, 0.40, 0.70, 0.05, 0.35}},
+  {{0.68, 0.12, 0.30, 0.72, 0.08, 0.45}},
+  {{0.82, 0.06, 0.20, 0.85, 0.04, 0.30}},
+  {{0.72, 0.12, 0.38, 0.76, 0.08, 0.42}},
+  {{0.74, 0.11, 0.40, 0.78, 0.07, 0.44}},
+  {{0.70, 0.14, 0.36, 0.74, 0.09, 0.40}},
+  {{0.66, 0.18, 0.45, 0.70, 0.12, 0.52}},
+  {{0.68, 0.16, 0.42, 0.72, 0.10, 0.48}},
+}};
+
+// A processor state chunk of any version, migrated to the current parameter set. values is in the
+// dense store layout (denseParamIndex ()); slots the chunk and its migration leave undefined are
+// not set in assigned; the controller keeps its current value for them, the processor its
+// initialize () value.
+struct ParameterStateSnapshot {
+  uint32 version {0};
+  int32 presetIndex {0};
+  ParameterImage values {};
+  std::bitset<kDenseParameterCount> assigned {};
+  // Saved from v10 on; older chunks leave hasRandomizer false.
+  RandomizerState randomizer {};
+  bool hasRandomizer {false};
+};
+
+// Reads the header and the whole parameter block of state with one read each and migrates it.
+// Returns false for unknown versions, truncated chunks and v9+ checksum mismatches; snapshot is
+// then unspecified.
+bool readParameterState (IBStream* state, ParameterStateSnapshot& snapshot);
+
+// Writes a v11 chunk (header with the randomizer state, checksum and the parameter block of
+// values, which is in the dense store layout) with a single IBStream::write.
+bool writeParameterState (IBStream* state, int32 presetIndex, const ParameterImage& values,
+                          const RandomizerState& randomizer, StateEncoding encoding);
+
+template <typename Apply>
+void forEachAssignedParam (const ParameterStateSnapshot& snapshot, Apply&& apply)
+{
+  for (int32 slot = 0; slot < kDenseParameterCount; ++slot)
+  {
+    if (snapshot.assigned.test (static_cast<size_t> (slot)))
+      apply (kDenseParamIdMap[slot], snapshot.values[slot]);
+  }
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Steinberg::WestCoastDrumSynth::Tests {
+
+// Benchmarks register through WCSD_TEST like the unit tests and run from the same main; they
+// print their timings and only check bounds loose enough to hold on a loaded machine.
+constexpr int kBenchmarkRuns = 7;
+
+// Best wall-clock time of kBenchmarkRuns calls of run, in milliseconds.
+template <typename Run>
+double bestOfMilliseconds (Run&& run)
+{
+  double best = 0.0;
+  for (int attempt = 0; attempt < kBenchmarkRuns; ++attempt)
+  {
+    const auto start = std::chrono::steady_clock::now ();
+    run ();
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now () - start;
+    best = attempt == 0 ? elapsed.count () : std::min (best, elapsed.count ());
+  }
+  return best;
+}
+
+// Keeps the optimizer from discarding rendered output the benchmark never reads.
+template <typename T>
+inline void doNotOptimize (const T& value)
+{
+  asm volatile ("" : : "r,m"(value) : "memory");
+}
+
+} // namespace Steinberg::WestCoastDrumSynth::Tests
@@ -0,0 +1,94 @@
+#include "TestHarness.h"
+
+#include "engine/FastMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Steinberg::WestCoastDrumSynth {
+namespace {
+
+// Largest deviation of approximation from reference over count evenly spaced points of [low, high],
+// relative to |reference| when relative is set.
+template <typename Approximation, typename Reference>
+double sweepError (Approximation approximation, Reference reference, double low, double high, int32_t count,
+                   bool relative)
+{
+  double worst = 0.0;
+  for (int32_t i = 0; i <= count; ++i)
+  {
+    const double x = low + ((high - low) * static_cast<double> (i) / static_cast<double> (count));
+    const double expected = reference (x);
+    double error = std::abs (approximation (x) - expected);
+    if (relative)
+      error /= std::abs (expected);
+    worst = std::max (worst, error);
+  }
+  return worst;
+}
+
+} // namespace
+
+// The bounds documented at the top of FastMath.h, against libm.
+
+WCSD_TEST (fastExp2MatchesLibm)
+{
+  const auto approximation = [] (double x) { return FastMath::exp2 (x); };
+  const auto reference = [] (double x) { return std::exp2 (x); };
+  WCSD_CHECK_LE (sweepError (approximation, reference, -1022.0, 1023.0, 2000000, true), 1e-11);
+  WCSD_CHECK_LE (sweepError (approximation, reference, -1.0, 1.0, 200000, true), 1e-11);
+  WCSD_CHECK (FastMath::exp2 (-1100.0) == 0.0);
+}
+
+WCSD_TEST (fastLog2MatchesLibm)
+{
+  const auto approximation = [] (double x) { return FastMath::log2 (x); };
+  const auto reference = [] (double x) { return std::log2 (x); };
+  WCSD_CHECK_LE (sweepError (approximation, reference, 0.5, 2.0, 2000000, false), 1e-15);
+
+  // Every binade of the normal range, mantissas spread across [1, 2).
+  double worst = 0.0;
+  for (int32_t i = 0; i < 2000000; ++i)
+  {
+    const double x = std::ldexp (1.0 + (static_cast<double> (i) / 2000000.0), (i % 2045) - 1022);
+    worst = std::max (worst, std::abs (FastMath::log2 (x) - std::log2 (x)));
+  }
+  WCSD_CHECK_LE (worst, 1.2e-13);
+}
+
+WCSD_TEST (fastPowMatchesLibm)
+{
+  double worst = 0.0;
+  for (int32_t i = 1; i <= 1000; ++i)
+  {
+    for (int32_t j = 0; j <= 300; ++j)
+    {
+      const double base = 2.0 * static_cast<double> (i) / 1000.0;
+      const double exponent = 3.0 * static_cast<double> (j) / 300.0;
+      const double expected = std::pow (base, exponent);
+      worst = std::max (worst, std::abs (FastMath::pow (base, exponent) - expected) / expected);
+    }
+  }
+  WCSD_CHECK_LE (worst, 1e-11);
+  WCSD_CHECK (FastMath::pow (0.0, 2.0) == 0.0);
+}
+
+WCSD_TEST (fastSinMatchesLibm)
+{
+  const auto approximation = [] (double x) { return FastMath::sin (x); };
+  const auto reference = [] (double x) { return std::sin (x); };
+  // Dense around the fold points +-pi/2, where the polynomial is evaluated at its widest argument.
+  WCSD_CHECK_LE (sweepError (approximation, reference, -4.0, 4.0, 2000000, false), 1e-11);
+  WCSD_CHECK_LE (sweepError (approximation, reference, -1.0e6, 1.0e6, 2000003, false), 1e-11);
+}
+
+WCSD_TEST (fastTanhMatchesLibm)
+{
+  const auto approximation = [] (double x) { return FastMath::tanh (x); };
+  const auto reference = [] (double x) { return std::tanh (x); };
+  WCSD_CHECK_LE (sweepError (approximation, reference, -30.0, 30.0, 2000000, false), 5e-12);
+  WCSD_CHECK_LE (sweepError (approximation, reference, -0.1, 0.1, 200000, false), 5e-12);
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
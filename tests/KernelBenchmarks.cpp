@@ -0,0 +1,119 @@
+#include "BenchmarkHarness.h"
+
+#include "engine/DrumVoiceBank.h"
+#include "presets/CompiledPresets.h"
+#include "presets/FactoryPresets.h"
+
+#include <array>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+namespace Steinberg::WestCoastDrumSynth {
+namespace {
+
+using Tests::bestOfMilliseconds;
+using Tests::doNotOptimize;
+
+constexpr double kSampleRate = 48000.0;
+constexpr int32 kBlockSize = 64;
+constexpr int32 kRenderSamples = 48000;
+constexpr int32 kRetriggerBlocks = 150;
+constexpr int32 kLongKickSamples = 4 * 48000;
+
+// The first factory lane of the given character, or nullptr if no preset uses it.
+const LaneFrame* factoryFrameFor (LaneCharacter character)
+{
+  for (const CompiledPreset& preset : getCompiledPresets ())
+    for (const LaneFrame& frame : preset.frames)
+      if (frame.character == character)
+        return &frame;
+  return nullptr;
+}
+
+std::array<LaneFrame, kLaneCount> onEveryLane (const LaneFrame& frame)
+{
+  std::array<LaneFrame, kLaneCount> frames {};
+  frames.fill (frame);
+  return frames;
+}
+
+// Renders numSamples of the lanes playing frames, retriggered every retriggerBlocks blocks.
+template <typename Sample>
+double renderMilliseconds (const std::array<LaneFrame, kLaneCount>& frames, int32 numSamples = kRenderSamples,
+                           int32 retriggerBlocks = kRetriggerBlocks)
+{
+  std::vector<typename DrumVoiceBankT<Sample>::Block> out (kBlockSize);
+  return bestOfMilliseconds ([&] {
+    DrumVoiceBankT<Sample> bank;
+    bank.setSampleRate (kSampleRate);
+    for (int32 block = 0; block < numSamples / kBlockSize; ++block)
+    {
+      if (block % retriggerBlocks == 0)
+      {
+        for (int32 lane = 0; lane < kLaneCount; ++lane)
+          bank.trigger (lane, frames[lane]);
+      }
+      bank.processBlock (out.data (), kBlockSize, kAllLanesMask);
+      doNotOptimize (out[kBlockSize - 1]);
+    }
+  });
+}
+
+// The factory kick with its body stretched to the longest decay: its noise and transient paths
+// end within about a second and a half, and the body rings on alone for the rest of kLongKickSamples.
+LaneFrame longKick ()
+{
+  LaneFrame frame = *factoryFrameFor (LaneCharacter::Kick);
+  frame.decaySeconds = 1.97;
+  return frame;
+}
+
+// The same hit with the transient and noise rendering for as long as the body.
+LaneFrame withRingingPaths (LaneFrame frame)
+{
+  frame.transientDecaySeconds = frame.decaySeconds;
+  frame.noiseDecaySeconds = frame.decaySeconds;
+  return frame;
+}
+
+template <typename Sample>
+void benchmarkDormantPaths (const char* precision)
+{
+  // One hit, never retriggered.
+  constexpr int32 kSingleHit = kLongKickSamples / kBlockSize;
+  const double dormant = renderMilliseconds<Sample> (onEveryLane (longKick ()), kLongKickSamples, kSingleHit);
+  const double ringing =
+    renderMilliseconds<Sample> (onEveryLane (withRingingPaths (longKick ())), kLongKickSamples, kSingleHit);
+  std::printf ("  %-6s long kick  dormant paths %7.2f ms  ringing paths %7.2f ms  (4 s, 8 lanes)\n", precision,
+               dormant, ringing);
+
+  // Skipping the dormant transient and noise paths leaves little more than the body to render.
+  WCSD_CHECK_LE (dormant, ringing * 0.8);
+}
+
+} // namespace
+
+WCSD_TEST (benchmarkDormantPathSkip)
+{
+  benchmarkDormantPaths<double> ("double");
+  benchmarkDormantPaths<float> ("float");
+}
+
+WCSD_TEST (benchmarkFactoryKits)
+{
+  for (size_t preset = 0; preset < kFactoryPresetCount; ++preset)
+  {
+    const std::array<LaneFrame, kLaneCount>& frames = getCompiledPresets ()[preset].frames;
+    const double inDouble = renderMilliseconds<double> (frames);
+    const double inFloat = renderMilliseconds<float> (frames);
+    const std::string_view name = getFactoryPresets ()[preset].name;
+    std::printf ("  %-24.*s double %7.2f ms  float %7.2f ms  (1 s, 8 lanes)\n", static_cast<int> (name.size ()),
+                 name.data (), inDouble, inFloat);
+
+    // Float converts its double phases and decays every sample but stays level with double.
+    WCSD_CHECK_LE (inFloat, inDouble * 1.5);
+  }
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,31 @@
+#include "TestHarness.h"
+
+#include "engine/LaneFrameBuilder.h"
+#include "presets/CompiledPresets.h"
+
+namespace Steinberg::WestCoastDrumSynth {
+
+WCSD_TEST (compiledFramesFollowTheGlobalOscFilter)
+{
+  constexpr double kOscFilterSettings[][3] = {{0.0, 0.0, 0.0}, {0.55, 0.9, 0.1}, {1.0, 1.0, 1.0}};
+  for (const CompiledPreset& preset : getCompiledPresets ())
+  {
+    ParameterImage params = preset.params;
+    params[denseParamIndex (kParamRandomizeAmount)] = kCompiledPresetMorph;
+    for (const auto& setting : kOscFilterSettings)
+    {
+      params[denseParamIndex (kParamOscFilterCutoff)] = setting[0];
+      params[denseParamIndex (kParamOscFilterResonance)] = setting[1];
+      params[denseParamIndex (kParamOscFilterEnv)] = setting[2];
+      WCSD_CHECK (compiledMorphMatches (params));
+
+      std::array<LaneFrame, kLaneCount> rebuilt {};
+      buildLaneFrames (params, kAllLanesMask, rebuilt);
+      std::array<LaneFrame, kLaneCount> retuned = preset.frames;
+      applyGlobalOscFilter (params, kAllLanesMask, retuned);
+      WCSD_CHECK (retuned == rebuilt);
+    }
+  }
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
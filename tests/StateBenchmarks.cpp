@@ -0,0 +1,57 @@
+#include "BenchmarkHarness.h"
+#include "StateFixtures.h"
+
+#include <cstdio>
+
+namespace Steinberg::WestCoastDrumSynth {
+namespace {
+
+using Tests::bestOfMilliseconds;
+using Tests::buildFixtureChunk;
+using Tests::ChunkStream;
+using Tests::doNotOptimize;
+
+constexpr int32 kLoadsPerRun = 2000;
+
+// Microseconds per readParameterState of the fixture chunk of version in encoding.
+double loadMicroseconds (uint32 version, StateEncoding encoding)
+{
+  ChunkStream stream (buildFixtureChunk (version, encoding));
+  ParameterStateSnapshot snapshot;
+  bool loaded = true;
+  const double milliseconds = bestOfMilliseconds ([&] {
+    for (int32 load = 0; load < kLoadsPerRun; ++load)
+    {
+      stream.rewind ();
+      loaded &= readParameterState (&stream, snapshot);
+      doNotOptimize (snapshot.values[0]);
+    }
+  });
+  WCSD_CHECK (loaded);
+  return milliseconds * 1000.0 / kLoadsPerRun;
+}
+
+} // namespace
+
+WCSD_TEST (benchmarkStateLoad)
+{
+  for (uint32 version = 1; version <= kStateVersion; ++version)
+  {
+    const double float64 = loadMicroseconds (version, StateEncoding::Float64);
+    if (version < 9)
+    {
+      std::printf ("  v%-2u  float64 %6.2f us\n", version, float64);
+    }
+    else
+    {
+      const double quantized = loadMicroseconds (version, StateEncoding::Quantized16);
+      std::printf ("  v%-2u  float64 %6.2f us  quantized16 %6.2f us\n", version, float64, quantized);
+      WCSD_CHECK_LE (quantized, 100.0);
+    }
+
+    // A load is two reads and a table walk, a few microseconds; 100 would mean a bad regression.
+    WCSD_CHECK_LE (float64, 100.0);
+  }
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
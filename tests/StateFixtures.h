@@ -0,0 +1,152 @@
+#pragma once
+
+#include "state/StateMigration.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace Steinberg::WestCoastDrumSynth::Tests {
+
+// An IBStream over a byte vector, enough for readParameterState and writeParameterState.
+class ChunkStream : public IBStream {
+public:
+  ChunkStream () = default;
+  explicit ChunkStream (std::vector<uint8> bytes) : bytes_ (std::move (bytes)) {}
+
+  tresult PLUGIN_API queryInterface (const TUID, void** obj) SMTG_OVERRIDE
+  {
+    *obj = nullptr;
+    return kNoInterface;
+  }
+  uint32 PLUGIN_API addRef () SMTG_OVERRIDE { return 1; }
+  uint32 PLUGIN_API release () SMTG_OVERRIDE { return 1; }
+
+  tresult PLUGIN_API read (void* buffer, int32 numBytes, int32* numBytesRead) SMTG_OVERRIDE
+  {
+    const auto count = std::min (static_cast<size_t> (std::max (numBytes, 0)), bytes_.size () - position_);
+    std::memcpy (buffer, bytes_.data () + position_, count);
+    position_ += count;
+    if (numBytesRead)
+      *numBytesRead = static_cast<int32> (count);
+    return kResultOk;
+  }
+
+  tresult PLUGIN_API write (void* buffer, int32 numBytes, int32* numBytesWritten) SMTG_OVERRIDE
+  {
+    const auto* bytes = static_cast<const uint8*> (buffer);
+    bytes_.insert (bytes_.end (), bytes, bytes + std::max (numBytes, 0));
+    if (numBytesWritten)
+      *numBytesWritten = numBytes;
+    return kResultOk;
+  }
+
+  tresult PLUGIN_API seek (int64 pos, int32 mode, int64* result) SMTG_OVERRIDE
+  {
+    const int64 base = mode == kIBSeekSet ? 0 : (mode == kIBSeekCur ? static_cast<int64> (position_)
+                                                                      : static_cast<int64> (bytes_.size ()));
+    position_ = static_cast<size_t> (std::clamp<int64> (base + pos, 0, static_cast<int64> (bytes_.size ())));
+    if (result)
+      *result = static_cast<int64> (position_);
+    return kResultOk;
+  }
+
+  tresult PLUGIN_API tell (int64* pos) SMTG_OVERRIDE
+  {
+    if (pos)
+      *pos = static_cast<int64> (position_);
+    return kResultOk;
+  }
+
+  // Rewinds, so one stream can be read again.
+  void rewind () { position_ = 0; }
+  const std::vector<uint8>& bytes () const { return bytes_; }
+
+private:
+  std::vector<uint8> bytes_;
+  size_t position_ {0};
+};
+
+// Saved states of every version as the plugin wrote them, rebuilt from the chunk formats rather
+// than through writeParameterState: the stored value count of each version is pinned here, and
+// the i-th stored value is fixtureValue (i).
+constexpr int32 kFixturePresetIndex = 3;
+constexpr uint64 kFixtureRandomizerSeed = 0x0123456789ABCDEFULL;
+constexpr uint64 kFixtureRandomizerGeneration = 42;
+
+// Indexed by version - 1.
+constexpr std::array<int32, kStateVersion> kFixtureStoredCounts {
+  38, 76, 96, 131, 235, 245, 254, 219, 219, 219, 230,
+};
+
+constexpr double fixtureValue (int32 index)
+{
+  return static_cast<double> (((index * 37) % 101) + 1) / 128.0;
+}
+
+inline void appendUInt32 (std::vector<uint8>& bytes, uint32 value)
+{
+  for (int32 i = 0; i < 4; ++i)
+    bytes.push_back (static_cast<uint8> (value >> (8 * i)));
+}
+
+inline void appendUInt64 (std::vector<uint8>& bytes, uint64 value)
+{
+  for (int32 i = 0; i < 8; ++i)
+    bytes.push_back (static_cast<uint8> (value >> (8 * i)));
+}
+
+inline uint32 fixtureChecksum (const uint8* bytes, size_t numBytes, uint32 hash = 2166136261u)
+{
+  for (size_t i = 0; i < numBytes; ++i)
+    hash = (hash ^ bytes[i]) * 16777619u;
+  return hash;
+}
+
+// v1-v8: version, preset index, doubles. v9: encoding, count and checksum follow the preset
+// index; v10+ put the randomizer seed and generation before the checksum. A count other than the
+// version's pinned one stores that many values instead (v9+ chunks carry their count).
+inline std::vector<uint8> buildFixtureChunk (uint32 version, StateEncoding encoding = StateEncoding::Float64,
+                                             int32 count = -1)
+{
+  if (count < 0)
+    count = kFixtureStoredCounts[version - 1];
+  std::vector<uint8> block;
+  for (int32 i = 0; i < count; ++i)
+  {
+    if (version >= 9 && encoding == StateEncoding::Quantized16)
+    {
+      const auto quantized = static_cast<uint16> (std::lround (fixtureValue (i) * 65535.0));
+      block.push_back (static_cast<uint8> (quantized));
+      block.push_back (static_cast<uint8> (quantized >> 8));
+    }
+    else
+    {
+      appendUInt64 (block, std::bit_cast<uint64> (fixtureValue (i)));
+    }
+  }
+
+  std::vector<uint8> chunk;
+  appendUInt32 (chunk, version);
+  appendUInt32 (chunk, static_cast<uint32> (kFixturePresetIndex));
+  if (version >= 9)
+  {
+    appendUInt32 (chunk, static_cast<uint32> (encoding));
+    appendUInt32 (chunk, static_cast<uint32> (count));
+    if (version >= 10)
+    {
+      appendUInt64 (chunk, kFixtureRandomizerSeed);
+      appendUInt64 (chunk, kFixtureRandomizerGeneration);
+    }
+    const uint32 checksum =
+      fixtureChecksum (block.data (), block.size (), fixtureChecksum (chunk.data () + 4, chunk.size () - 4));
+    appendUInt32 (chunk, checksum);
+  }
+  chunk.insert (chunk.end (), block.begin (), block.end ());
+  return chunk;
+}
+
+} // namespace Steinberg::WestCoastDrumSynth::Tests
@@ -0,0 +1,259 @@
+#include "StateFixtures.h"
+#include "TestHarness.h"
+
+#include <cmath>
+
+namespace Steinberg::WestCoastDrumSynth {
+namespace {
+
+using Tests::buildFixtureChunk;
+using Tests::ChunkStream;
+using Tests::fixtureValue;
+
+constexpr uint32 kFirstChecksummedVersion = 9;
+constexpr uint32 kFirstRandomizerVersion = 10;
+// Quantized values may sit a rounding step past the documented tolerance after dequantizing.
+constexpr double kQuantizedCheckTolerance = kQuantizedStateTolerance * (1.0 + 1.0e-9);
+
+bool loadChunk (std::vector<uint8> bytes, ParameterStateSnapshot& snapshot)
+{
+  ChunkStream stream (std::move (bytes));
+  return readParameterState (&stream, snapshot);
+}
+
+bool isAssigned (const ParameterStateSnapshot& snapshot, Vst::ParamID id)
+{
+  return snapshot.assigned.test (static_cast<size_t> (denseParamIndex (id)));
+}
+
+double valueOf (const ParameterStateSnapshot& snapshot, Vst::ParamID id)
+{
+  return snapshot.values[denseParamIndex (id)];
+}
+
+// True when id holds the fixture's index-th stored value.
+bool holdsStored (const ParameterStateSnapshot& snapshot, Vst::ParamID id, int32 index, double tolerance)
+{
+  return isAssigned (snapshot, id) && std::abs (valueOf (snapshot, id) - fixtureValue (index)) <= tolerance;
+}
+
+bool holds (const ParameterStateSnapshot& snapshot, Vst::ParamID id, double value)
+{
+  return isAssigned (snapshot, id) && valueOf (snapshot, id) == value;
+}
+
+// Every stored value of the first count entries of ids landed on its parameter.
+template <size_t N>
+bool holdsStoredPrefix (const ParameterStateSnapshot& snapshot, const std::array<Vst::ParamID, N>& ids, int32 count,
+                        double tolerance)
+{
+  for (int32 i = 0; i < count; ++i)
+  {
+    if (!holdsStored (snapshot, ids[static_cast<size_t> (i)], i, tolerance))
+      return false;
+  }
+  return true;
+}
+
+Vst::ParamID core (int32 lane, LaneParamOffset offset)
+{
+  return laneParamID (lane, offset);
+}
+
+void checkLegacyLayouts ()
+{
+  ParameterStateSnapshot v1;
+  WCSD_CHECK (loadChunk (buildFixtureChunk (1), v1));
+  // Six globals, then lane-major core groups of four lanes; the fifth lane copies the fourth.
+  WCSD_CHECK (holdsStored (v1, kParamPresetSelect, 5, 0.0));
+  WCSD_CHECK (holdsStored (v1, core (3, kLaneTune), 6 + (3 * kLaneParamCount), 0.0));
+  WCSD_CHECK (holds (v1, core (4, kLaneTune), fixtureValue (6 + (3 * kLaneParamCount))));
+  const double lane3Pan = fixtureValue (6 + (3 * kLaneParamCount) + kLanePan);
+  WCSD_CHECK (holds (v1, core (4, kLanePan), std::min (1.0, lane3Pan + 0.08)));
+  WCSD_CHECK (!isAssigned (v1, core (5, kLaneTune)));
+  WCSD_CHECK (holds (v1, laneExtraParamID (2, kLanePitchEnvAmount), kLaneExtraDefaults[2][0]));
+  WCSD_CHECK (holds (v1, laneMacroParamID (7, kLaneTransientDecay), kLaneMacroDefaults[7][0]));
+  WCSD_CHECK (holds (v1, laneFilterParamID (0, kLaneOscFilterCutoff), kLaneFilterDefaults[0][0]));
+  WCSD_CHECK (holds (v1, kParamOscFilterCutoff, 0.20));
+  WCSD_CHECK (!isAssigned (v1, kParamRandomizeAmount));
+
+  ParameterStateSnapshot v2;
+  WCSD_CHECK (loadChunk (buildFixtureChunk (2), v2));
+  // Five lanes of core then extra groups; lanes 5-7 and every macro and filter default.
+  WCSD_CHECK (holdsStored (v2, core (4, kLanePan), 6 + (5 * kLaneParamCount) - 1, 0.0));
+  WCSD_CHECK (holdsStored (v2, laneExtraParamID (0, kLanePitchEnvAmount), 6 + (5 * kLaneParamCount), 0.0));
+  WCSD_CHECK (holds (v2, core (5, kLaneTune), 0.5));
+  WCSD_CHECK (holds (v2, laneExtraParamID (6, kLanePitchEnvAmount), kLaneExtraDefaults[6][0]));
+  WCSD_CHECK (holds (v2, laneMacroParamID (0, kLaneTransientDecay), kLaneMacroDefaults[0][0]));
+  WCSD_CHECK (holds (v2, kParamOscFilterEnv, 0.46));
+
+  ParameterStateSnapshot v3;
+  WCSD_CHECK (loadChunk (buildFixtureChunk (3), v3));
+  // v2 plus five lanes of macros.
+  WCSD_CHECK (holdsStored (v3, laneMacroParamID (0, kLaneTransientDecay), 76, 0.0));
+  WCSD_CHECK (holdsStored (v3, laneMacroParamID (4, kLaneNoiseEnvAmount), 95, 0.0));
+  WCSD_CHECK (holds (v3, laneMacroParamID (5, kLaneTransientDecay), kLaneMacroDefaults[5][0]));
+  WCSD_CHECK (holds (v3, laneFilterParamID (4, kLaneOscFilterCutoff), kLaneFilterDefaults[4][0]));
+  WCSD_CHECK (holds (v3, kParamOscFilterResonance, 0.34));
+
+  ParameterStateSnapshot v4;
+  WCSD_CHECK (loadChunk (buildFixtureChunk (4), v4));
+  // A prefix of the current ID list; lanes 5-7 then reset to their defaults.
+  WCSD_CHECK (holdsStoredPrefix (v4, allParameterIds (), kParamGlobalCount + (5 * kLaneParamCount), 0.0));
+  WCSD_CHECK (holds (v4, core (5, kLaneTune), 0.5));
+  WCSD_CHECK (holds (v4, laneFilterParamID (7, kLaneOscFilterCutoff), kLaneFilterDefaults[7][0]));
+  WCSD_CHECK (!isAssigned (v4, laneMuteParamID (0)));
+}
+
+void checkNineLaneLayouts ()
+{
+  constexpr int32 kV7CoreStart = kParamGlobalCount;
+  constexpr int32 kV7MuteStart = kV7TotalParameterCount - (2 * kV7LaneCount);
+  constexpr int32 kV7OscMixStart = kV7TotalParameterCount - kV7LaneCount;
+
+  ParameterStateSnapshot v5;
+  WCSD_CHECK (loadChunk (buildFixtureChunk (5), v5));
+  // A prefix of the v7 list; the ninth lane is dropped, mutes and osc mixes default.
+  WCSD_CHECK (holdsStored (v5, core (6, kLaneTune), kV7CoreStart + (6 * kLaneParamCount), 0.0));
+  WCSD_CHECK (holds (v5, kParamRandomizeAmount, 1.0));
+  WCSD_CHECK (holds (v5, laneMuteParamID (2), 0.0));
+  WCSD_CHECK (holds (v5, laneOscMixParamID (2), 1.0));
+
+  ParameterStateSnapshot v6;
+  WCSD_CHECK (loadChunk (buildFixtureChunk (6), v6));
+  WCSD_CHECK (holdsStored (v6, kParamRandomizeAmount, kParamRandomizeAmount, 0.0));
+  WCSD_CHECK (holdsStored (v6, laneMuteParamID (2), kV7MuteStart + 2, 0.0));
+  WCSD_CHECK (holds (v6, laneOscMixParamID (2), 1.0));
+
+  ParameterStateSnapshot v7;
+  WCSD_CHECK (loadChunk (buildFixtureChunk (7), v7));
+  // Lane 6 of the nine was dropped and lane 8 moved into its place.
+  WCSD_CHECK (holdsStored (v7, core (5, kLaneTune), kV7CoreStart + (5 * kLaneParamCount), 0.0));
+  WCSD_CHECK (holdsStored (v7, core (6, kLaneTune), kV7CoreStart + (8 * kLaneParamCount), 0.0));
+  WCSD_CHECK (holdsStored (v7, core (7, kLanePan), kV7CoreStart + (8 * kLaneParamCount) - 1, 0.0));
+  WCSD_CHECK (holdsStored (v7, laneMuteParamID (6), kV7MuteStart + 8, 0.0));
+  WCSD_CHECK (holdsStored (v7, laneOscMixParamID (6), kV7OscMixStart + 8, 0.0));
+  WCSD_CHECK (!isAssigned (v7, kParamKitMorph));
+}
+
+void checkCurrentLayouts (StateEncoding encoding)
+{
+  const double tolerance = encoding == StateEncoding::Quantized16 ? kQuantizedCheckTolerance : 0.0;
+  for (uint32 version = 8; version <= kStateVersion; ++version)
+  {
+    if (version < kFirstChecksummedVersion && encoding != StateEncoding::Float64)
+      continue;
+
+    ParameterStateSnapshot snapshot;
+    WCSD_CHECK (loadChunk (buildFixtureChunk (version, encoding), snapshot));
+    const int32 count = Tests::kFixtureStoredCounts[version - 1];
+    WCSD_CHECK (holdsStoredPrefix (snapshot, allParameterIds (), count, tolerance));
+    if (count < kTotalParameterCount)
+    {
+      WCSD_CHECK (holds (snapshot, kParamKitMorph, 0.0));
+      WCSD_CHECK (holds (snapshot, kParamQuality, 0.0));
+      WCSD_CHECK (holds (snapshot, laneOversamplingParamID (7), 0.0));
+    }
+  }
+}
+
+// A v11 chunk stores whatever prefix of allParameterIds () its writer knew; the rest start at
+// their defaults, and more values than the current list holds is a damaged chunk.
+void checkStoredPrefixes (StateEncoding encoding)
+{
+  const double tolerance = encoding == StateEncoding::Quantized16 ? kQuantizedCheckTolerance : 0.0;
+  constexpr int32 kWithQuality = kTotalParameterCount - kLaneOversamplingParamCount;
+  for (const int32 count : {Tests::kFixtureStoredCounts[7], kWithQuality - kQualityParamCount, kWithQuality})
+  {
+    ParameterStateSnapshot snapshot;
+    WCSD_CHECK (loadChunk (buildFixtureChunk (kStateVersion, encoding, count), snapshot));
+    WCSD_CHECK (holdsStoredPrefix (snapshot, allParameterIds (), count, tolerance));
+    WCSD_CHECK (holds (snapshot, laneOversamplingParamID (0), 0.0));
+    if (count < kWithQuality)
+      WCSD_CHECK (holds (snapshot, kParamQuality, 0.0));
+  }
+
+  ParameterStateSnapshot snapshot;
+  WCSD_CHECK (!loadChunk (buildFixtureChunk (kStateVersion, encoding, kTotalParameterCount + 1), snapshot));
+}
+
+} // namespace
+
+WCSD_TEST (stateFixturesLoadEveryVersion)
+{
+  for (uint32 version = 1; version <= kStateVersion; ++version)
+  {
+    for (const StateEncoding encoding : {StateEncoding::Float64, StateEncoding::Quantized16})
+    {
+      if (version < kFirstChecksummedVersion && encoding != StateEncoding::Float64)
+        continue;
+
+      ParameterStateSnapshot snapshot;
+      WCSD_CHECK (loadChunk (buildFixtureChunk (version, encoding), snapshot));
+      WCSD_CHECK (snapshot.version == version);
+      WCSD_CHECK (snapshot.presetIndex == Tests::kFixturePresetIndex);
+      WCSD_CHECK (snapshot.hasRandomizer == (version >= kFirstRandomizerVersion));
+      if (snapshot.hasRandomizer)
+      {
+        WCSD_CHECK (snapshot.randomizer.seed == Tests::kFixtureRandomizerSeed);
+        WCSD_CHECK (snapshot.randomizer.generation == Tests::kFixtureRandomizerGeneration);
+      }
+    }
+  }
+}
+
+WCSD_TEST (stateFixturesMigrateToTheCurrentLayout)
+{
+  checkLegacyLayouts ();
+  checkNineLaneLayouts ();
+  checkCurrentLayouts (StateEncoding::Float64);
+  checkCurrentLayouts (StateEncoding::Quantized16);
+  checkStoredPrefixes (StateEncoding::Float64);
+  checkStoredPrefixes (StateEncoding::Quantized16);
+}
+
+WCSD_TEST (stateFixturesRejectDamagedChunks)
+{
+  for (uint32 version = 1; version <= kStateVersion; ++version)
+  {
+    ParameterStateSnapshot snapshot;
+    std::vector<uint8> truncated = buildFixtureChunk (version);
+    truncated.pop_back ();
+    WCSD_CHECK (!loadChunk (truncated, snapshot));
+
+    if (version < kFirstChecksummedVersion)
+      continue;
+    for (const StateEncoding encoding : {StateEncoding::Float64, StateEncoding::Quantized16})
+    {
+      std::vector<uint8> corrupted = buildFixtureChunk (version, encoding);
+      corrupted.back () ^= 0x01;
+      WCSD_CHECK (!loadChunk (corrupted, snapshot));
+    }
+  }
+
+  ParameterStateSnapshot snapshot;
+  std::vector<uint8> future = buildFixtureChunk (kStateVersion);
+  future[0] = static_cast<uint8> (kStateVersion + 1);
+  WCSD_CHECK (!loadChunk (future, snapshot));
+}
+
+WCSD_TEST (stateRoundTripsInBothEncodings)
+{
+  ParameterStateSnapshot saved;
+  WCSD_CHECK (loadChunk (buildFixtureChunk (kStateVersion), saved));
+
+  for (const StateEncoding encoding : {StateEncoding::Float64, StateEncoding::Quantized16})
+  {
+    ChunkStream stream;
+    WCSD_CHECK (writeParameterState (&stream, saved.presetIndex, saved.values, saved.randomizer, encoding));
+    WCSD_CHECK (stream.bytes () == buildFixtureChunk (kStateVersion, encoding));
+
+    ParameterStateSnapshot reloaded;
+    stream.rewind ();
+    WCSD_CHECK (readParameterState (&stream, reloaded));
+    const double tolerance = encoding == StateEncoding::Quantized16 ? kQuantizedCheckTolerance : 0.0;
+    WCSD_CHECK (holdsStoredPrefix (reloaded, allParameterIds (), kTotalParameterCount, tolerance));
+  }
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
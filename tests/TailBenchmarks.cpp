@@ -0,0 +1,91 @@
+#include "BenchmarkHarness.h"
+
+#include "engine/DrumVoiceBank.h"
+#include "engine/LaneMixState.h"
+#include "engine/ScopedFlushDenormals.h"
+#include "presets/CompiledPresets.h"
+#include "presets/FactoryPresets.h"
+
+#include <array>
+#include <cstdio>
+#include <string_view>
+
+namespace Steinberg::WestCoastDrumSynth {
+namespace {
+
+using Tests::bestOfMilliseconds;
+using Tests::doNotOptimize;
+
+constexpr double kSampleRate = 48000.0;
+constexpr int32 kBlockSize = 64;
+// The first 100 ms of a hit, then 8 s after it: every factory kit rings down within about 5 s,
+// leaving seconds of silence that process () still renders block by block.
+constexpr int32 kAttackSamples = 4800;
+constexpr int32 kTailSamples = 8 * 48000;
+
+// The voice path of process (): the bank renders and the lane mix sums it, under the same guard.
+template <typename Sample>
+struct TailRender {
+  DrumVoiceBankT<Sample> bank;
+  LaneMixState mix;
+
+  void render (int32 numSamples)
+  {
+    const ScopedFlushDenormals flushDenormals;
+    std::array<LaneArray<Sample>, kBlockSize> block {};
+    std::array<Sample, kBlockSize> left {};
+    std::array<Sample, kBlockSize> right {};
+    for (int32 start = 0; start < numSamples; start += kBlockSize)
+    {
+      bank.processBlock (block.data (), kBlockSize, mix.activeMask ());
+      mix.mix (block.data (), kBlockSize, left.data (), right.data ());
+      doNotOptimize (left[kBlockSize - 1]);
+    }
+  }
+};
+
+template <typename Sample>
+void benchmarkSilentTail (const char* precision)
+{
+  for (size_t preset = 0; preset < kFactoryPresetCount; ++preset)
+  {
+    const std::array<LaneFrame, kLaneCount>& frames = getCompiledPresets ()[preset].frames;
+    TailRender<Sample> struck;
+    struck.bank.setSampleRate (kSampleRate);
+    struck.mix.setSampleRate (kSampleRate);
+    struck.mix.update (frames, 0);
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+      struck.bank.trigger (lane, frames[lane]);
+    TailRender<Sample> decaying = struck;
+    decaying.render (kAttackSamples);
+
+    TailRender<Sample> render;
+    const double attack = bestOfMilliseconds ([&] {
+      render = struck;
+      render.render (kAttackSamples);
+    });
+    const double tail = bestOfMilliseconds ([&] {
+      render = decaying;
+      render.render (kTailSamples);
+    });
+    const double attackPerSample = attack * 1.0e6 / kAttackSamples;
+    const double tailPerSample = tail * 1.0e6 / kTailSamples;
+    const std::string_view name = getFactoryPresets ()[preset].name;
+    std::printf ("  %-6s %-24.*s attack %6.1f ns/sample  tail %6.1f ns/sample  (8 lanes, %d s tail)\n",
+                 precision, static_cast<int> (name.size ()), name.data (), attackPerSample, tailPerSample,
+                 kTailSamples / static_cast<int32> (kSampleRate));
+
+    // Decaying filter and DC states reaching the denormal range cost far more than this.
+    WCSD_CHECK_LE (tailPerSample, attackPerSample * 3.0);
+  }
+}
+
+} // namespace
+
+WCSD_TEST (benchmarkSilentTail)
+{
+  benchmarkSilentTail<double> ("double");
+  benchmarkSilentTail<float> ("float");
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+namespace Steinberg::WestCoastDrumSynth::Tests {
+
+// A minimal self-registering test runner for the engine, which builds without the SDK's hosting
+// sources. WCSD_TEST defines a test; a failed WCSD_CHECK is reported and the test carries on.
+struct TestCase {
+  const char* name;
+  void (*run) ();
+};
+
+inline std::vector<TestCase>& registry ()
+{
+  static std::vector<TestCase> tests;
+  return tests;
+}
+
+inline int& failureCount ()
+{
+  static int failures = 0;
+  return failures;
+}
+
+struct Registration {
+  Registration (const char* name, void (*run) ())
+  {
+    registry ().push_back ({name, run});
+  }
+};
+
+inline void reportFailure (const char* file, int line, const char* expression)
+{
+  std::fprintf (stderr, "%s:%d: check failed: %s\n", file, line, expression);
+  ++failureCount ();
+}
+
+inline void reportFailure (const char* file, int line, const char* expression, double value, double bound)
+{
+  std::fprintf (stderr, "%s:%d: check failed: %s (%.17g vs %.17g)\n", file, line, expression, value, bound);
+  ++failureCount ();
+}
+
+} // namespace Steinberg::WestCoastDrumSynth::Tests
+
+#define WCSD_TEST(name)                                                                                  \
+  static void name ();                                                                                   \
+  static const ::Steinberg::WestCoastDrumSynth::Tests::Registration name##Registration {#name, &name}; \
+  static void name ()
+
+#define WCSD_CHECK(condition)                                                               \
+  do                                                                                        \
+  {                                                                                         \
+    if (!(condition))                                                                       \
+      ::Steinberg::WestCoastDrumSynth::Tests::reportFailure (__FILE__, __LINE__, #condition); \
+  } while (false)
+
+// Checks value <= bound and prints both when it fails.
+#define WCSD_CHECK_LE(value, bound)                                                                          \
+  do                                                                                                         \
+  {                                                                                                          \
+    const double checkedValue = (value);                                                                     \
+    const double checkedBound = (bound);                                                                     \
+    if (!(checkedValue <= checkedBound))                                                                     \
+      ::Steinberg::WestCoastDrumSynth::Tests::reportFailure (__FILE__, __LINE__, #value " <= " #bound,       \
+                                                             checkedValue, checkedBound);                    \
+  } while (false)
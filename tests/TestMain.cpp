@@ -0,0 +1,23 @@
+#include "TestHarness.h"
+
+#include <cstring>
+
+// Runs every registered test, or only those whose name contains the first argument.
+int main (int argc, char** argv)
+{
+  using namespace Steinberg::WestCoastDrumSynth::Tests;
+
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+  int run = 0;
+  for (const TestCase& test : registry ())
+  {
+    if (filter != nullptr && std::strstr (test.name, filter) == nullptr)
+      continue;
+    const int failuresBefore = failureCount ();
+    test.run ();
+    std::printf ("%s %s\n", failureCount () == failuresBefore ? "[  OK  ]" : "[ FAIL ]", test.name);
+    ++run;
+  }
+  std::printf ("%d tests, %d failed checks\n", run, failureCount ());
+  return failureCount () == 0 ? 0 : 1;
+}
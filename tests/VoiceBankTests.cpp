@@ -0,0 +1,283 @@
+#include "TestHarness.h"
+
+#include "engine/DrumVoiceBank.h"
+#include "engine/KitMorph.h"
+#include "presets/CompiledPresets.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Steinberg::WestCoastDrumSynth {
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr int32 kBlockSize = 64;
+
+// Renders numSamples of every lane through the bank in kBlockSize blocks.
+template <typename Sample>
+void renderBlocks (DrumVoiceBankT<Sample>& bank, int32 numSamples,
+                   std::vector<typename DrumVoiceBankT<Sample>::Block>& out)
+{
+  out.resize (static_cast<size_t> (numSamples));
+  for (int32 start = 0; start < numSamples; start += kBlockSize)
+    bank.processBlock (out.data () + start, std::min (kBlockSize, numSamples - start), kAllLanesMask);
+}
+
+// Triggers every lane of factory preset presetIndex and renders numSamples through the bank.
+template <typename Sample>
+void renderKit (DrumVoiceBankT<Sample>& bank, size_t presetIndex, int32 numSamples,
+                std::vector<typename DrumVoiceBankT<Sample>::Block>& out)
+{
+  const auto& frames = getCompiledPresets ()[presetIndex].frames;
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+    bank.trigger (lane, frames[lane]);
+  renderBlocks (bank, numSamples, out);
+}
+
+// Renders numSamples of a hit of preset 0's kit, retunes every lane to that kit blended
+// position of the way towards preset 3's and renders numSamples more into out.
+std::vector<DrumVoiceBank::Block> renderRetunedKit (double position, int32 numSamples)
+{
+  LaneFrameBank from;
+  LaneFrameBank to;
+  packLaneFrames (getCompiledPresets ()[0].frames, from);
+  packLaneFrames (getCompiledPresets ()[3].frames, to);
+  std::array<LaneFrame, kLaneCount> frames {};
+  blendLaneFrames (from, to, position, frames);
+
+  DrumVoiceBank bank;
+  bank.setSampleRate (kSampleRate);
+  std::vector<DrumVoiceBank::Block> out;
+  renderKit (bank, 0, numSamples, out);
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+    bank.retune (lane, frames[lane]);
+  renderBlocks (bank, numSamples, out);
+  return out;
+}
+
+VoiceDsp::CoefficientErrorStats coefficientErrorAt (int32 controlInterval)
+{
+  DrumVoiceBank bank;
+  bank.setSampleRate (kSampleRate);
+  bank.setControlInterval (controlInterval);
+  bank.setCoefficientErrorTracking (true);
+
+  std::vector<DrumVoiceBank::Block> out;
+  for (size_t preset = 0; preset < kFactoryPresetCount; ++preset)
+    renderKit (bank, preset, 9600, out);
+  return bank.coefficientErrorStats ();
+}
+
+} // namespace
+
+WCSD_TEST (controlIntervalKeepsTheControlRate)
+{
+  using VoiceDsp::controlIntervalFor;
+  WCSD_CHECK (controlIntervalFor (48000.0) == VoiceDsp::kDefaultControlInterval);
+  WCSD_CHECK (controlIntervalFor (96000.0) == VoiceDsp::clampControlInterval (2 * VoiceDsp::kDefaultControlInterval));
+  WCSD_CHECK (controlIntervalFor (1000.0) >= 1);
+  WCSD_CHECK (controlIntervalFor (1.0e7) == VoiceDsp::kMaxControlInterval);
+}
+
+WCSD_TEST (coefficientErrorGrowsWithControlInterval)
+{
+  const VoiceDsp::CoefficientErrorStats everySample = coefficientErrorAt (1);
+  const VoiceDsp::CoefficientErrorStats standard = coefficientErrorAt (16);
+  const VoiceDsp::CoefficientErrorStats coarse = coefficientErrorAt (32);
+
+  // With an update every sample the ramp lands on each exact coefficient; the default interval
+  // of 16 keeps the SVF coefficients (2 sin (pi fc / fs)) within 2e-3 of the exact ones.
+  WCSD_CHECK (standard.count > 0);
+  WCSD_CHECK (coarse.count == standard.count);
+  WCSD_CHECK_LE (everySample.maxAbsError, 1e-12);
+  WCSD_CHECK_LE (standard.maxAbsError, 2e-3);
+  WCSD_CHECK_LE (VoiceDsp::rmsError (standard), 2e-5);
+  WCSD_CHECK (coarse.maxAbsError > standard.maxAbsError);
+  WCSD_CHECK (VoiceDsp::rmsError (coarse) > VoiceDsp::rmsError (standard));
+}
+
+WCSD_TEST (kitTailBoundsEveryHit)
+{
+  DrumVoiceBank bank;
+  bank.setSampleRate (kSampleRate);
+  for (size_t preset = 0; preset < kFactoryPresetCount; ++preset)
+  {
+    const auto& frames = getCompiledPresets ()[preset].frames;
+    const uint32 kitTail = bank.tailSamplesFor (frames);
+    WCSD_CHECK (bank.activeMask () == 0);
+
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+      bank.trigger (lane, frames[lane]);
+    WCSD_CHECK_LE (bank.tailSamples (), kitTail);
+
+    DrumVoiceBank::Block block {};
+    uint32 rendered = 0;
+    while (bank.activeMask () != 0 && rendered <= kitTail)
+    {
+      bank.processBlock (&block, 1, kAllLanesMask);
+      ++rendered;
+    }
+    WCSD_CHECK_LE (rendered, kitTail);
+  }
+}
+
+WCSD_TEST (retuneCarriesSoundingHits)
+{
+  constexpr int32 kHalf = 1024;
+  DrumVoiceBank bank;
+  bank.setSampleRate (kSampleRate);
+  std::vector<DrumVoiceBank::Block> untouched;
+  renderKit (bank, 0, 2 * kHalf, untouched);
+  untouched.erase (untouched.begin (), untouched.begin () + kHalf);
+  std::vector<DrumVoiceBank::Block> restarted;
+  renderKit (bank, 3, kHalf, restarted);
+
+  // Retuning to the frames a hit started with changes nothing. A 1% morph step moves the next
+  // sample by a fraction of a percent, and a full one carries on from the hit rather than
+  // restarting it as a new trigger would.
+  WCSD_CHECK (renderRetunedKit (0.0, kHalf) == untouched);
+  const std::vector<DrumVoiceBank::Block> stepped = renderRetunedKit (0.01, kHalf);
+  const std::vector<DrumVoiceBank::Block> retuned = renderRetunedKit (1.0, kHalf);
+  WCSD_CHECK (stepped != untouched);
+  double steppedJump = 0.0;
+  double restartJump = 0.0;
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    steppedJump = std::max (steppedJump, std::abs (stepped[0][lane] - untouched[0][lane]));
+    restartJump = std::max (restartJump, std::abs (retuned[0][lane] - restarted[0][lane]));
+  }
+  WCSD_CHECK_LE (steppedJump, 0.01);
+  WCSD_CHECK (restartJump > 0.5);
+}
+
+WCSD_TEST (retuneRampsTheGains)
+{
+  constexpr int32 kHalf = 1024;
+  const auto& frames = getCompiledPresets ()[0].frames;
+  DrumVoiceBank bank;
+  bank.setSampleRate (kSampleRate);
+  std::vector<DrumVoiceBank::Block> untouched;
+  renderKit (bank, 0, 2 * kHalf, untouched);
+
+  DrumVoiceBank retunedBank;
+  retunedBank.setSampleRate (kSampleRate);
+  std::vector<DrumVoiceBank::Block> before;
+  renderKit (retunedBank, 0, kHalf, before);
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    LaneFrame quieter = frames[lane];
+    quieter.outputLevel *= 0.5;
+    retunedBank.retune (lane, quieter);
+  }
+  std::vector<DrumVoiceBank::Block> after;
+  renderBlocks (retunedBank, kHalf, after);
+
+  // Halving the output level leaves the first sample after the retune where it was and reaches
+  // half within one control interval. The DC blocker remembers the louder samples for seconds, so
+  // the level is compared on its input, whose differences are y[n] - kDcCoef * y[n - 1].
+  const int32 interval = retunedBank.controlInterval ();
+  const auto blockerInput = [] (const std::vector<DrumVoiceBank::Block>& out, size_t i, int32 lane) {
+    return out[i][lane] - VoiceDsp::kDcCoef * out[i - 1][lane];
+  };
+  double firstJump = 0.0;
+  double settledError = 0.0;
+  double peak = 0.0;
+  for (int32 lane = 0; lane < kLaneCount; ++lane)
+  {
+    firstJump = std::max (firstJump, std::abs (after[0][lane] - untouched[kHalf][lane]));
+    for (int32 i = interval + 1; i < kHalf; ++i)
+    {
+      const double expected = 0.5 * blockerInput (untouched, kHalf + i, lane);
+      settledError = std::max (settledError, std::abs (blockerInput (after, i, lane) - expected));
+      peak = std::max (peak, std::abs (expected));
+    }
+  }
+  WCSD_CHECK (firstJump == 0.0);
+  WCSD_CHECK_LE (settledError, peak * 1.0e-9);
+}
+
+WCSD_TEST (floatKitTracksTheDoubleReference)
+{
+  // Float rounding inside the kernel leaves every lane of every kit at least 45 dB below its
+  // double reference (the worst measured is about 53). A looser match means something that
+  // should stay double, like the phases or the envelope decays, went float.
+  constexpr double kMaxErrorToSignal = 3.16e-5;
+  for (size_t preset = 0; preset < kFactoryPresetCount; ++preset)
+  {
+    DrumVoiceBank reference;
+    DrumVoiceBankT<float> bank;
+    reference.setSampleRate (kSampleRate);
+    bank.setSampleRate (kSampleRate);
+    std::vector<DrumVoiceBank::Block> expected;
+    std::vector<DrumVoiceBankT<float>::Block> rendered;
+    renderKit (reference, preset, 9600, expected);
+    renderKit (bank, preset, 9600, rendered);
+
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+    {
+      double signalEnergy = 0.0;
+      double errorEnergy = 0.0;
+      for (size_t i = 0; i < expected.size (); ++i)
+      {
+        const double error = static_cast<double> (rendered[i][lane]) - expected[i][lane];
+        signalEnergy += expected[i][lane] * expected[i][lane];
+        errorEnergy += error * error;
+      }
+      WCSD_CHECK_LE (errorEnergy, signalEnergy * kMaxErrorToSignal);
+    }
+  }
+}
+
+WCSD_TEST (oversampledFoldKeepsItsGateAligned)
+{
+  // A short, lightly folded 150 Hz body with nothing else in the lane: rendered oversampled and
+  // shifted back by the bank latency, it has to match the 1x render closely. It does not when
+  // the body leaves the fold later than the filter sweep and gate it meets.
+  constexpr int32 kLength = 4800;
+  for (const int32 factor : {2, kMaxOversampling})
+  {
+    DrumVoiceBank reference;
+    DrumVoiceBank oversampled;
+    reference.setSampleRate (kSampleRate);
+    oversampled.setSampleRate (kSampleRate);
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+      oversampled.setOversampling (lane, factor);
+    const auto latency = static_cast<int32> (oversampled.latencySamples ());
+
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+    {
+      LaneFrame frame = getCompiledPresets ()[0].frames[lane];
+      frame.frequencyHz = 150.0;
+      frame.decaySeconds = 0.01;
+      frame.foldAmount = 0.05;
+      frame.fmAmount = 0.0;
+      frame.pitchEnvAmount = 0.0;
+      frame.noiseLevel = 0.0;
+      frame.transientLevel = 0.0;
+      frame.driveAmount = 0.0;
+      reference.trigger (lane, frame);
+      oversampled.trigger (lane, frame);
+    }
+    std::vector<DrumVoiceBank::Block> expected;
+    std::vector<DrumVoiceBank::Block> rendered;
+    renderBlocks (reference, kLength, expected);
+    renderBlocks (oversampled, kLength + latency, rendered);
+
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+    {
+      double signalEnergy = 0.0;
+      double errorEnergy = 0.0;
+      for (int32 i = 0; i < kLength; ++i)
+      {
+        const double error = rendered[static_cast<size_t> (i + latency)][lane] - expected[i][lane];
+        signalEnergy += expected[i][lane] * expected[i][lane];
+        errorEnergy += error * error;
+      }
+      // 33 dB down; measured 36 to 40 dB aligned and 24 to 30 dB with the gate early.
+      WCSD_CHECK_LE (errorEnergy, signalEnergy * 5.0e-4);
+    }
+  }
+}
+
+} // namespace Steinberg::WestCoastDrumSynth
@@ -0,0 +1,121 @@
+#include "TestHarness.h"
+
+#include "engine/DrumVoiceBank.h"
+#include "engine/VoiceDsp.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace Steinberg::WestCoastDrumSynth {
+namespace {
+
+// The reflection loop the closed-form wavefold () replaced.
+template <typename T>
+T wavefoldByReflection (T x)
+{
+  for (int32_t i = 0; i < 5; ++i)
+  {
+    if (x > T (1))
+      x = T (2) - x;
+    else if (x < T (-1))
+      x = T (-2) - x;
+  }
+  return x;
+}
+
+// Where the closed form could slip: a fine sweep well past the reach, a few hundred ulps either
+// side of every integer up to twice the reach (reflection points and rounding boundaries of the
+// nearest multiple of 4), random values, and the extremes and non-finite values.
+template <typename T>
+std::vector<T> wavefoldInputs ()
+{
+  constexpr T kInfinity = std::numeric_limits<T>::infinity ();
+  std::vector<T> inputs;
+  for (int32_t i = -40 * 1024; i <= 40 * 1024; ++i)
+    inputs.push_back (static_cast<T> (i) / T (1024));
+
+  for (int32_t edge = -22; edge <= 22; ++edge)
+  {
+    T below = static_cast<T> (edge);
+    T above = below;
+    for (int32_t step = 0; step < 256; ++step)
+    {
+      below = std::nextafter (below, -kInfinity);
+      above = std::nextafter (above, kInfinity);
+      inputs.push_back (below);
+      inputs.push_back (above);
+    }
+  }
+
+  uint32_t seed = 0x2545F491u;
+  for (int32_t i = 0; i < 100000; ++i)
+  {
+    seed = (seed * 1664525u) + 1013904223u;
+    inputs.push_back (static_cast<T> ((static_cast<double> (seed) / 4294967296.0 * 80.0) - 40.0));
+  }
+
+  for (const T x : {T (0), -T (0), std::numeric_limits<T>::denorm_min (), std::numeric_limits<T>::max (),
+                    std::numeric_limits<T>::lowest (), kInfinity, -kInfinity, std::numeric_limits<T>::quiet_NaN ()})
+    inputs.push_back (x);
+  return inputs;
+}
+
+// Bit for bit, with any NaN matching any other.
+template <typename T>
+bool sameValue (T a, T b)
+{
+  if (std::isnan (a) || std::isnan (b))
+    return std::isnan (a) && std::isnan (b);
+  return std::memcmp (&a, &b, sizeof (T)) == 0;
+}
+
+template <typename T>
+int32_t countMismatches ()
+{
+  int32_t mismatches = 0;
+  for (const T x : wavefoldInputs<T> ())
+    mismatches += sameValue (VoiceDsp::wavefold (x), wavefoldByReflection (x)) ? 0 : 1;
+  return mismatches;
+}
+
+// The same inputs folded kLaneCount at a time in the loop shape of the voice bank's kernel, built
+// with its compile options, so the comparison covers the code the compiler vectorizes there.
+template <typename T>
+int32_t countLaneMismatches ()
+{
+  const std::vector<T> inputs = wavefoldInputs<T> ();
+  int32_t mismatches = 0;
+  for (size_t start = 0; start + kLaneCount <= inputs.size (); start += kLaneCount)
+  {
+    LaneArray<T> foldInput {};
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+      foldInput[lane] = inputs[start + lane];
+    LaneArray<T> folded {};
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+      folded[lane] = VoiceDsp::wavefold (foldInput[lane]);
+    for (int32 lane = 0; lane < kLaneCount; ++lane)
+      mismatches += sameValue (folded[lane], wavefoldByReflection (foldInput[lane])) ? 0 : 1;
+  }
+  return mismatches;
+}
+
+} // namespace
+
+WCSD_TEST (wavefoldMatchesTheReflectionLoop)
+{
+  WCSD_CHECK (countMismatches<float> () == 0);
+  WCSD_CHECK (countMismatches<double> () == 0);
+  WCSD_CHECK (std::isnan (VoiceDsp::wavefold (std::numeric_limits<float>::quiet_NaN ())));
+  WCSD_CHECK (std::isnan (VoiceDsp::wavefold (std::numeric_limits<double>::quiet_NaN ())));
+}
+
+WCSD_TEST (wavefoldLanesMatchTheReflectionLoop)
+{
+  WCSD_CHECK (countLaneMismatches<float> () == 0);
+  WCSD_CHECK (countLaneMismatches<double> () == 0);
+}
+
+} // namespace Steinberg::WestCoastDrumSynth